@@ -148,6 +148,16 @@ const FEOSSettings& UEOSSettings::ManualGetSettings()
 		GConfig->GetString(INI_SECTION, TEXT("DefaultArtifactName"), CachedSettings->DefaultArtifactName, GEngineIni);
 		GConfig->GetInt(INI_SECTION, TEXT("TickBudgetInMilliseconds"), CachedSettings->TickBudgetInMilliseconds, GEngineIni);
 		GConfig->GetInt(INI_SECTION, TEXT("TitleStorageReadChunkLength"), CachedSettings->TitleStorageReadChunkLength, GEngineIni);
+		GConfig->GetInt(INI_SECTION, TEXT("SessionUpdateMinIntervalInMilliseconds"), CachedSettings->SessionUpdateMinIntervalInMilliseconds, GEngineIni);
+		GConfig->GetInt(INI_SECTION, TEXT("SessionSearchResultsBudgetInMilliseconds"), CachedSettings->SessionSearchResultsBudgetInMilliseconds, GEngineIni);
+		GConfig->GetInt(INI_SECTION, TEXT("SessionSearchCacheTTLInMilliseconds"), CachedSettings->SessionSearchCacheTTLInMilliseconds, GEngineIni);
+		GConfig->GetBool(INI_SECTION, TEXT("bRevalidateStaleSessionSearches"), CachedSettings->bRevalidateStaleSessionSearches, GEngineIni);
+		GConfig->GetInt(INI_SECTION, TEXT("MaxConcurrentUserInfoQueries"), CachedSettings->MaxConcurrentUserInfoQueries, GEngineIni);
+		GConfig->GetInt(INI_SECTION, TEXT("UserInfoCacheTTLInMilliseconds"), CachedSettings->UserInfoCacheTTLInMilliseconds, GEngineIni);
+		GConfig->GetInt(INI_SECTION, TEXT("UserInfoCacheMaxEntries"), CachedSettings->UserInfoCacheMaxEntries, GEngineIni);
+		GConfig->GetInt(INI_SECTION, TEXT("PresenceUpdateBudgetInMilliseconds"), CachedSettings->PresenceUpdateBudgetInMilliseconds, GEngineIni);
+		GConfig->GetInt(INI_SECTION, TEXT("SetPresenceMinIntervalInMilliseconds"), CachedSettings->SetPresenceMinIntervalInMilliseconds, GEngineIni);
+		GConfig->GetBool(INI_SECTION, TEXT("bUseP2PNetworkThread"), CachedSettings->bUseP2PNetworkThread, GEngineIni);
 		GConfig->GetBool(INI_SECTION, TEXT("bEnableOverlay"), CachedSettings->bEnableOverlay, GEngineIni);
 		GConfig->GetBool(INI_SECTION, TEXT("bEnableSocialOverlay"), CachedSettings->bEnableSocialOverlay, GEngineIni);
 		GConfig->GetBool(INI_SECTION, TEXT("bShouldEnforceBeingLaunchedByEGS"), CachedSettings->bShouldEnforceBeingLaunchedByEGS, GEngineIni);
@@ -172,6 +182,16 @@ const FEOSSettings& UEOSSettings::ManualGetSettings()
 	Native.DefaultArtifactName = DefaultArtifactName;
 	Native.TickBudgetInMilliseconds = TickBudgetInMilliseconds;
 	Native.TitleStorageReadChunkLength = TitleStorageReadChunkLength;
+	Native.SessionUpdateMinIntervalInMilliseconds = SessionUpdateMinIntervalInMilliseconds;
+	Native.SessionSearchResultsBudgetInMilliseconds = SessionSearchResultsBudgetInMilliseconds;
+	Native.SessionSearchCacheTTLInMilliseconds = SessionSearchCacheTTLInMilliseconds;
+	Native.bRevalidateStaleSessionSearches = bRevalidateStaleSessionSearches;
+	Native.MaxConcurrentUserInfoQueries = MaxConcurrentUserInfoQueries;
+	Native.UserInfoCacheTTLInMilliseconds = UserInfoCacheTTLInMilliseconds;
+	Native.UserInfoCacheMaxEntries = UserInfoCacheMaxEntries;
+	Native.PresenceUpdateBudgetInMilliseconds = PresenceUpdateBudgetInMilliseconds;
+	Native.SetPresenceMinIntervalInMilliseconds = SetPresenceMinIntervalInMilliseconds;
+	Native.bUseP2PNetworkThread = bUseP2PNetworkThread;
 	Native.bEnableOverlay = bEnableOverlay;
 	Native.bEnableSocialOverlay = bEnableSocialOverlay;
 	Native.bShouldEnforceBeingLaunchedByEGS = bShouldEnforceBeingLaunchedByEGS;
@@ -14,38 +14,65 @@ inline uint8 PortToChannel(int32 InPort)
 FInternetAddrEOS::FInternetAddrEOS()
 	: LocalUserId(nullptr)
 	, RemoteUserId(nullptr)
+	, SocketNameId(0)
 	, Channel(0)
 {
-	SocketName[0] = '\0';
 }
 
 FInternetAddrEOS::FInternetAddrEOS(const FString& InRemoteUserId, const FString& InSocketName, const int32 InChannel)
 	: LocalUserId(nullptr)
 	, RemoteUserId(nullptr)
+	, SocketNameId(0)
+	, Channel(0)
 {
 #if WITH_EOS_SDK
 	RemoteUserId = EOS_ProductUserId_FromString(TCHAR_TO_UTF8(*InRemoteUserId));
 #endif
-	FCStringAnsi::Strcpy(SocketName, TCHAR_TO_UTF8(*InSocketName));
 	Channel = PortToChannel(InChannel);
+	SetSocketName(InSocketName);
 }
 
 #if WITH_EOS_SDK
 FInternetAddrEOS::FInternetAddrEOS(const EOS_ProductUserId InRemoteUserId, const FString& InSocketName, const int32 InChannel)
 	: LocalUserId(nullptr)
 	, RemoteUserId(InRemoteUserId)
-	, Channel(InChannel)
+	, SocketNameId(0)
+	, Channel(0)
 {
-	FCStringAnsi::Strcpy(SocketName, TCHAR_TO_UTF8(*InSocketName));
 	Channel = PortToChannel(InChannel);
+	SetSocketName(InSocketName);
 }
 #endif
 
+FInternetAddrEOS::FInternetAddrEOS(const FInternetAddrEOS& Other)
+	: LocalUserId(Other.LocalUserId)
+	, RemoteUserId(Other.RemoteUserId)
+	, SocketNameId(Other.SocketNameId)
+	, Channel(Other.Channel)
+	, Strings(Other.Strings)
+{
+	FSocketSubsystemEOS::AddSocketNameRef(SocketNameId);
+}
+
+FInternetAddrEOS::~FInternetAddrEOS()
+{
+	FSocketSubsystemEOS::ReleaseSocketName(SocketNameId);
+}
+
 void FInternetAddrEOS::SetIp(uint32)
 {
 	UE_LOG(LogSocketSubsystemEOS, Warning, TEXT("Calls to FInternetAddrEOS::SetIp are not valid"));
 }
 
+/** Copies part of a URL into a null terminated UTF8 buffer, truncating it to fit. Short parts don't allocate */
+static void CopyUrlPart(const TCHAR* Part, int32 PartLen, char* Buffer, int32 BufferSize)
+{
+	FTCHARToUTF8 Converted(Part, PartLen);
+	const int32 CopyLen = FMath::Min(Converted.Length(), BufferSize - 1);
+	FMemory::Memcpy(Buffer, Converted.Get(), CopyLen);
+	Buffer[CopyLen] = '\0';
+}
+
 void FInternetAddrEOS::SetIp(const TCHAR* InAddr, bool& bIsValid)
 {
 	bIsValid = false;
@@ -56,35 +83,69 @@ void FInternetAddrEOS::SetIp(const TCHAR* InAddr, bool& bIsValid)
 	}
 
 	Channel = 0;
+	// Until the parse succeeds, ToString formats whatever it left behind
+	Strings.Reset();
 
-	TArray<FString> UrlParts;
-	FString FullAddress = InAddr;
-	FullAddress.ParseIntoArray(UrlParts, EOS_URL_SEPARATOR, false);
-	// Expect URLs to look like "EOS:PUID:SocketName:Channel" and channel can be optional
-	if (UrlParts.Num() < 3 || UrlParts.Num() > 4)
+	// Expect URLs to look like "EOS:PUID:SocketName:Channel" and channel can be optional.
+	// Split in place rather than with ParseIntoArray, as this runs for every connection attempt
+	const TCHAR Separator = EOS_URL_SEPARATOR[0];
+	const TCHAR* UrlParts[4];
+	int32 UrlPartLens[4];
+	int32 NumParts = 0;
+	const TCHAR* PartStart = InAddr;
+	for (const TCHAR* Char = InAddr; ; ++Char)
+	{
+		if (*Char != Separator && *Char != TEXT('\0'))
+		{
+			continue;
+		}
+		if (NumParts == UE_ARRAY_COUNT(UrlParts))
+		{
+			return;
+		}
+		UrlParts[NumParts] = PartStart;
+		UrlPartLens[NumParts] = UE_PTRDIFF_TO_INT32(Char - PartStart);
+		NumParts++;
+		if (*Char == TEXT('\0'))
+		{
+			break;
+		}
+		PartStart = Char + 1;
+	}
+	if (NumParts < 3)
 	{
 		return;
 	}
-	if (UrlParts[0] != EOS_CONNECTION_URL_PREFIX)
+	if (UrlPartLens[0] != FCString::Strlen(EOS_CONNECTION_URL_PREFIX) || FCString::Strnicmp(UrlParts[0], EOS_CONNECTION_URL_PREFIX, UrlPartLens[0]) != 0)
 	{
 		return;
 	}
 #if WITH_EOS_SDK
-	RemoteUserId = EOS_ProductUserId_FromString(TCHAR_TO_UTF8(*UrlParts[1]));
+	char PuidBuffer[EOS_PRODUCTUSERID_MAX_LENGTH + 1];
+	if (UrlPartLens[1] > EOS_PRODUCTUSERID_MAX_LENGTH)
+	{
+		return;
+	}
+	CopyUrlPart(UrlParts[1], UrlPartLens[1], PuidBuffer, UE_ARRAY_COUNT(PuidBuffer));
+	RemoteUserId = EOS_ProductUserId_FromString(PuidBuffer);
 	if (EOS_ProductUserId_IsValid(RemoteUserId) == EOS_FALSE)
 #endif
 	{
 		return;
 	}
-	if (UrlParts[2].Len() == 0)
+	if (UrlPartLens[2] == 0)
 	{
 		return;
 	}
-	SetSocketName(UrlParts[2]);
-	if (UrlParts.Num() == 4)
+	char SocketNameBuffer[EOS_SOCKET_NAME_SIZE];
+	CopyUrlPart(UrlParts[2], UrlPartLens[2], SocketNameBuffer, UE_ARRAY_COUNT(SocketNameBuffer));
+	if (NumParts == 4)
 	{
-		Channel = FCString::Atoi(*UrlParts[3]);
+		// The channel is the last part, so it runs to the end of the string
+		Channel = FCString::Atoi(UrlParts[3]);
 	}
+	// Sets the name last, so the strings are only rebuilt once
+	SetSocketName(SocketNameBuffer);
 	bIsValid = true;
 }
 
@@ -98,6 +159,7 @@ void FInternetAddrEOS::GetIp(uint32& OutAddr) const
 void FInternetAddrEOS::SetPort(int32 InPort)
 {
 	Channel = PortToChannel(InPort);
+	UpdateStrings();
 }
 
 int32 FInternetAddrEOS::GetPort() const
@@ -145,6 +207,16 @@ void FInternetAddrEOS::SetLoopbackAddress()
 }
 
 FString FInternetAddrEOS::ToString(bool bAppendPort) const
+{
+	if (Strings.IsValid())
+	{
+		return bAppendPort ? Strings->WithPort : Strings->WithoutPort;
+	}
+	// Nothing was ever set, which is rare enough to format on demand rather than cache
+	return BuildString(bAppendPort);
+}
+
+FString FInternetAddrEOS::BuildString(bool bAppendPort) const
 {
 	char PuidBuffer[64];
 	int32 BufferLen = 64;
@@ -157,21 +229,29 @@ FString FInternetAddrEOS::ToString(bool bAppendPort) const
 
 	if (bAppendPort)
 	{
-		return FString::Printf(TEXT("%s%s%s%s%s%s%u"), EOS_CONNECTION_URL_PREFIX, EOS_URL_SEPARATOR, UTF8_TO_TCHAR(PuidBuffer), EOS_URL_SEPARATOR, UTF8_TO_TCHAR(SocketName), EOS_URL_SEPARATOR, Channel);
+		return FString::Printf(TEXT("%s%s%s%s%s%s%u"), EOS_CONNECTION_URL_PREFIX, EOS_URL_SEPARATOR, UTF8_TO_TCHAR(PuidBuffer), EOS_URL_SEPARATOR, UTF8_TO_TCHAR(GetSocketName()), EOS_URL_SEPARATOR, Channel);
 	}
+	return FString::Printf(TEXT("%s%s%s%s%s"), EOS_CONNECTION_URL_PREFIX, EOS_URL_SEPARATOR, UTF8_TO_TCHAR(PuidBuffer), EOS_URL_SEPARATOR, UTF8_TO_TCHAR(GetSocketName()));
+}
 
-	return FString::Printf(TEXT("%s%s%s%s%s"), EOS_CONNECTION_URL_PREFIX, EOS_URL_SEPARATOR, UTF8_TO_TCHAR(PuidBuffer), EOS_URL_SEPARATOR, UTF8_TO_TCHAR(SocketName));
+void FInternetAddrEOS::UpdateStrings()
+{
+	// Built into a new object rather than in place, since copies of this address may be reading the old one
+	TSharedRef<FInternetAddrStringsEOS, ESPMode::ThreadSafe> NewStrings = MakeShared<FInternetAddrStringsEOS, ESPMode::ThreadSafe>();
+	NewStrings->WithoutPort = BuildString(false);
+	NewStrings->WithPort = FString::Printf(TEXT("%s%s%u"), *NewStrings->WithoutPort, EOS_URL_SEPARATOR, Channel);
+	Strings = NewStrings;
 }
 
 uint32 FInternetAddrEOS::GetTypeHash() const
 {
-	return HashCombine(HashCombine(HashCombine(::GetTypeHash((void*)LocalUserId), ::GetTypeHash((void *)RemoteUserId)), ::GetTypeHash(SocketName)), Channel);
+	return HashCombine(HashCombine(HashCombine(::GetTypeHash((void*)LocalUserId), ::GetTypeHash((void *)RemoteUserId)), SocketNameId), Channel);
 }
 
 bool FInternetAddrEOS::IsValid() const
 {
 #if WITH_EOS_SDK
-	return (EOS_ProductUserId_IsValid(LocalUserId) == EOS_TRUE || EOS_ProductUserId_IsValid(RemoteUserId) == EOS_TRUE) && FCStringAnsi::Strlen(SocketName) > 0;
+	return (EOS_ProductUserId_IsValid(LocalUserId) == EOS_TRUE || EOS_ProductUserId_IsValid(RemoteUserId) == EOS_TRUE) && SocketNameId != 0;
 #else
 	return false;
 #endif
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "IPAddress.h"
+#include "OnlineSubsystemNames.h"
+#include "SocketSubsystemEOS.h"
 
 #if WITH_EOS_SDK
 #if defined(EOS_PLATFORM_BASE_FILE_NAME)
@@ -16,6 +18,13 @@ DECLARE_LOG_CATEGORY_EXTERN(LogSocketSubsystemEOS, Log, All);
 
 #define EOS_SOCKET_NAME_SIZE 33
 
+/** ToString results for an address, see FInternetAddrEOS::UpdateStrings */
+struct FInternetAddrStringsEOS
+{
+	FString WithPort;
+	FString WithoutPort;
+};
+
 class FInternetAddrEOS
 	: public FInternetAddr
 {
@@ -25,7 +34,9 @@ public:
 #if WITH_EOS_SDK
 	FInternetAddrEOS(const EOS_ProductUserId InRemoteUserId, const FString& InSocketName, const int32 InChannel);
 #endif
-	virtual ~FInternetAddrEOS() = default;
+	/** Copies hold their own reference to the interned socket name */
+	FInternetAddrEOS(const FInternetAddrEOS& Other);
+	virtual ~FInternetAddrEOS();
 
 //~ Begin FInternetAddr Interface
 	virtual void SetIp(uint32 InAddr) override;
@@ -42,16 +53,31 @@ public:
 	virtual uint32 GetTypeHash() const override;
 	virtual bool IsValid() const override;
 	virtual TSharedRef<FInternetAddr> Clone() const override;
+	virtual FName GetProtocolType() const override
+	{
+		return EOS_SUBSYSTEM;
+	}
 //~ End FInternetAddr Interface
 
 	FORCEINLINE FInternetAddrEOS& operator=(const FInternetAddrEOS& Other)
 	{
+		// Take the new reference before dropping the old, in case both are the same name
+		FSocketSubsystemEOS::AddSocketNameRef(Other.SocketNameId);
+		FSocketSubsystemEOS::ReleaseSocketName(SocketNameId);
 		LocalUserId = Other.LocalUserId;
 		RemoteUserId = Other.RemoteUserId;
-		FCStringAnsi::Strcpy(SocketName, Other.SocketName);
+		SocketNameId = Other.SocketNameId;
 		Channel = Other.Channel;
+		Strings = Other.Strings;
 		return *this;
 	}
+
+	/** Overridden so address keyed maps compare ids instead of the base class's raw ip strings */
+	virtual bool operator==(const FInternetAddr& Other) const override
+	{
+		// Passthrough drivers mix in IP addresses, which can never equal one of ours
+		return Other.GetProtocolType() == GetProtocolType() && *this == static_cast<const FInternetAddrEOS&>(Other);
+	}
 	
 	FORCEINLINE friend bool operator==(const FInternetAddrEOS& A, const FInternetAddrEOS& B)
 	{
@@ -60,7 +86,7 @@ public:
 			&& A.LocalUserId == B.LocalUserId
 			&& A.RemoteUserId == B.RemoteUserId
 #endif
-			&& FCStringAnsi::Stricmp(A.GetSocketName(), B.GetSocketName()) == 0;
+			&& A.SocketNameId == B.SocketNameId;
 	}
 
 	FORCEINLINE friend bool operator!=(const FInternetAddrEOS& A, const FInternetAddrEOS& B)
@@ -75,23 +101,20 @@ public:
 
 	friend bool operator<(const FInternetAddrEOS& Left, const FInternetAddrEOS& Right)
 	{
-#if WITH_EOS_SDK
-		if (Left.GetLocalUserId() < Right.GetLocalUserId())
+		if (Left.LocalUserId != Right.LocalUserId)
 		{
-			return true;
+			return Left.LocalUserId < Right.LocalUserId;
 		}
-		else if (Left.GetRemoteUserId() < Right.GetRemoteUserId())
+		if (Left.RemoteUserId != Right.RemoteUserId)
 		{
-			return true;
+			return Left.RemoteUserId < Right.RemoteUserId;
 		}
-		else
-#endif
-		if (FCStringAnsi::Stricmp(Left.GetSocketName(), Right.GetSocketName()) < 0)
+		// Orders by id rather than by name, which is all containers need
+		if (Left.SocketNameId != Right.SocketNameId)
 		{
-			return true;
+			return Left.SocketNameId < Right.SocketNameId;
 		}
-
-		return Left.GetChannel() < Right.GetChannel();
+		return Left.Channel < Right.Channel;
 	}
 
 #if WITH_EOS_SDK
@@ -108,6 +131,7 @@ public:
 	void SetRemoteUserId(EOS_ProductUserId InRemoteUserId)
 	{
 		RemoteUserId = InRemoteUserId;
+		UpdateStrings();
 	}
 
 	EOS_ProductUserId GetRemoteUserId() const
@@ -128,6 +152,7 @@ public:
 	void SetRemoteUserId(void* InRemoteUserId)
 	{
 		RemoteUserId = InRemoteUserId;
+		UpdateStrings();
 	}
 
 	void* GetRemoteUserId() const
@@ -138,17 +163,25 @@ public:
 	
 	const char* GetSocketName() const
 	{
-		return SocketName;
+		return FSocketSubsystemEOS::GetSocketName(SocketNameId);
+	}
+
+	FSocketNameIdEOS GetSocketNameId() const
+	{
+		return SocketNameId;
 	}
 
 	void SetSocketName(const FString& InSocketName)
 	{
-		FCStringAnsi::Strncpy(SocketName, TCHAR_TO_UTF8(*InSocketName), EOS_SOCKET_NAME_SIZE);
+		SetSocketName(TCHAR_TO_UTF8(*InSocketName));
 	}
 
 	void SetSocketName(const char* InSocketName)
 	{
-		FCStringAnsi::Strncpy(SocketName, InSocketName, EOS_SOCKET_NAME_SIZE);
+		const FSocketNameIdEOS NewSocketNameId = FSocketSubsystemEOS::InternSocketName(InSocketName);
+		FSocketSubsystemEOS::ReleaseSocketName(SocketNameId);
+		SocketNameId = NewSocketNameId;
+		UpdateStrings();
 	}
 
 	uint8 GetChannel() const
@@ -159,9 +192,16 @@ public:
 	void SetChannel(uint8 InChannel)
 	{
 		Channel = InChannel;
+		UpdateStrings();
 	}
 
 private:
+	/** Rebuilds Strings. Called by everything that changes a part of them, so ToString only ever reads */
+	void UpdateStrings();
+
+	/** Formats the address from its parts */
+	FString BuildString(bool bAppendPort) const;
+
 #if WITH_EOS_SDK
 	EOS_ProductUserId LocalUserId;
 	EOS_ProductUserId RemoteUserId;
@@ -169,8 +209,12 @@ private:
 	void* LocalUserId;
 	void* RemoteUserId;
 #endif
-	char SocketName[EOS_SOCKET_NAME_SIZE];
+	/** Interned socket name we hold a reference to, see FSocketSubsystemEOS::InternSocketName */
+	FSocketNameIdEOS SocketNameId;
 	uint8 Channel;
 
+	/** ToString results, shared between copies and replaced (never edited) whenever a part of them changes. Null until a part is set */
+	TSharedPtr<const FInternetAddrStringsEOS, ESPMode::ThreadSafe> Strings;
+
 	friend class SocketSubsystemEOS;
 };
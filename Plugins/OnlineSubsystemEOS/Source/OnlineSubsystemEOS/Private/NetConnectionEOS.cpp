@@ -54,6 +54,28 @@ void UNetConnectionEOS::CleanUp()
 	}
 }
 
+void UNetConnectionEOS::LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits)
+{
+	Super::LowLevelSend(Data, CountBits, Traits);
+
+	if (bHasP2PSession)
+	{
+		P2PTrafficStats.PacketsSent++;
+		P2PTrafficStats.BytesSent += FMath::DivideAndRoundUp(CountBits, 8);
+	}
+}
+
+void UNetConnectionEOS::ReceivedRawPacket(void* Data, int32 Count)
+{
+	if (bHasP2PSession)
+	{
+		P2PTrafficStats.PacketsReceived++;
+		P2PTrafficStats.BytesReceived += Count;
+	}
+
+	Super::ReceivedRawPacket(Data, Count);
+}
+
 void UNetConnectionEOS::DestroyEOSConnection()
 {
 	if (!Socket)
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "IpConnection.h"
+#include "SocketEOS.h"
 #include "NetConnectionEOS.generated.h"
 
 UCLASS(Transient, Config=Engine)
@@ -19,13 +20,23 @@ public:
 	virtual void InitLocalConnection(UNetDriver* InDriver, FSocket* InSocket, const FURL& InURL, EConnectionState InState, int32 InMaxPacket = 0, int32 InPacketOverhead = 0) override;
 	virtual void InitRemoteConnection(UNetDriver* InDriver, FSocket* InSocket, const FURL& InURL, const FInternetAddr& InRemoteAddr, EConnectionState InState, int32 InMaxPacket = 0, int32 InPacketOverhead = 0) override;
 	virtual void CleanUp() override;
+	virtual void LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits) override;
+	virtual void ReceivedRawPacket(void* Data, int32 Count) override;
 //~ End NetConnection Interface
 
 	void DestroyEOSConnection();
 
+	/** @return P2P traffic this connection has handed to, or been handed by, its socket. Send failures are only tracked by the socket */
+	const FP2PTrafficStatsEOS& GetP2PTrafficStats() const
+	{
+		return P2PTrafficStats;
+	}
+
 public:
 	bool bIsPassthrough;
 
 protected:
 	bool bHasP2PSession;
+
+	FP2PTrafficStatsEOS P2PTrafficStats;
 };
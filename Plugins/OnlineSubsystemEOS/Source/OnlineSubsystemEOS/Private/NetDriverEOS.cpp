@@ -78,6 +78,14 @@ bool UNetDriverEOS::InitBase(bool bInitAsClient, FNetworkNotify* InNotify, const
 	EOSLocalAddress->SetSocketName(NetDriverName.ToString());
 
 	static_cast<FSocketEOS*>(GetSocket())->SetLocalAddress(*EOSLocalAddress);
+	static_cast<FSocketEOS*>(GetSocket())->SetPacketAggregation(bUseP2PPacketAggregation);
+
+	// Side channels can pick SDK level delivery from the URL, e.g. ?P2PReliability=ReliableOrdered
+	FP2PChannelProfileEOS ChannelProfile;
+	if (FSocketSubsystemEOS::ParseChannelProfile(*FString::Join(URL.Op, TEXT(" ")), ChannelProfile))
+	{
+		static_cast<FSocketEOS*>(GetSocket())->SetChannelProfile(ChannelProfile);
+	}
 
 	LocalAddr = LocalAddress;
 
@@ -212,6 +220,34 @@ int UNetDriverEOS::GetClientPort()
 	return 49152;
 }
 
+void UNetDriverEOS::TickDispatch(float DeltaTime)
+{
+	if (!bIsPassthrough)
+	{
+		if (FSocketEOS* const SocketEOS = static_cast<FSocketEOS*>(GetSocket()))
+		{
+			// Drain what the SDK has queued for us in one pass, so the receive loop in Super is served from the ring
+			SocketEOS->ReceiveBatch(MaxP2PPacketsPerBatch > 0 ? MaxP2PPacketsPerBatch : EOS_P2P_RECEIVE_BATCH_SIZE);
+		}
+	}
+
+	Super::TickDispatch(DeltaTime);
+}
+
+void UNetDriverEOS::TickFlush(float DeltaSeconds)
+{
+	Super::TickFlush(DeltaSeconds);
+
+	if (!bIsPassthrough)
+	{
+		if (FSocketEOS* const SocketEOS = static_cast<FSocketEOS*>(GetSocket()))
+		{
+			// Everything replicated this tick has been written, so send the aggregated frames
+			SocketEOS->FlushPendingSends();
+		}
+	}
+}
+
 UWorld* UNetDriverEOS::FindWorld() const
 {
 	UWorld* MyWorld = GetWorld();
@@ -23,6 +23,8 @@ public:
 	virtual ISocketSubsystem* GetSocketSubsystem() override;
 	virtual void Shutdown() override;
 	virtual int GetClientPort() override;
+	virtual void TickDispatch(float DeltaTime) override;
+	virtual void TickFlush(float DeltaSeconds) override;
 //~ End UNetDriver Interface
 
 	UWorld* FindWorld() const;
@@ -33,4 +35,12 @@ public:
 
 	UPROPERTY(Config)
 	bool bIsUsingP2PSockets;
+
+	/** Max number of P2P packets pulled from the SDK in one batch at the start of each TickDispatch (0 uses the default) */
+	UPROPERTY(Config)
+	int32 MaxP2PPacketsPerBatch;
+
+	/** Pack small outgoing packets for the same remote into one P2P packet, flushed at the end of each tick. Must match on both ends */
+	UPROPERTY(Config)
+	bool bUseP2PPacketAggregation;
 };
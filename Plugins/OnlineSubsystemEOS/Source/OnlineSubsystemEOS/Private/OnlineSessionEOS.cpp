@@ -14,6 +14,7 @@
 #include "IEOSSDKManager.h"
 #include "NetDriverEOS.h"
 #include "EOSVoiceChatUser.h"
+#include "EOSSettings.h"
 
 #if WITH_EOS_SDK
 	#include "eos_sessions.h"
@@ -108,6 +109,65 @@ EOS_EOnlineComparisonOp ToEOSSearchOp(EOnlineComparisonOp::Type Op)
 	return EOS_EOnlineComparisonOp::EOS_OCO_EQUAL;
 }
 
+/** Returns Prefix + Name encoded as UTF-8, encoding it only the first time it is asked for */
+static const char* EncodeAttributeKey(TMap<FName, TArray<ANSICHAR>>& EncodedKeys, FName Name, const TCHAR* Prefix)
+{
+	TArray<ANSICHAR>* EncodedKey = EncodedKeys.Find(Name);
+	if (EncodedKey == nullptr)
+	{
+		const FTCHARToUTF8 KeyUtf8(*(Prefix + Name.ToString()));
+		EncodedKey = &EncodedKeys.Add(Name, TArray<ANSICHAR>(KeyUtf8.Get(), KeyUtf8.Length() + 1));
+	}
+	return EncodedKey->GetData();
+}
+
+/** The UTF-8 key a setting is published under. Session names are few, so they are kept for the life of the process */
+static const char* GetAttributeKey(FName Name)
+{
+	static TMap<FName, TArray<ANSICHAR>> EncodedKeys;
+	return EncodeAttributeKey(EncodedKeys, Name, TEXT(""));
+}
+
+/** The UTF-8 key a search param is matched against */
+static const char* GetSearchAttributeKey(FName Name)
+{
+	static TMap<FName, TArray<ANSICHAR>> EncodedKeys;
+	return EncodeAttributeKey(EncodedKeys, Name, TEXT("FOSS="));
+}
+
+/** Settings published as attributes of their own rather than through FOnlineSessionSettings::Settings */
+enum class EBuiltInAttributeEOS : uint8
+{
+	None,
+	OwningUserId,
+	OwningUserName,
+	NumPublicConnections,
+	NumPrivateConnections,
+	AntiCheatProtected,
+	UsesStats,
+	IsDedicated,
+	BuildUniqueId
+};
+
+/** Which built in setting an attribute read back from the backend holds, if any */
+static EBuiltInAttributeEOS GetBuiltInAttribute(FName Key)
+{
+	static const TMap<FName, EBuiltInAttributeEOS> BuiltInAttributes =
+	{
+		{ FName(TEXT("OwningUserId")), EBuiltInAttributeEOS::OwningUserId },
+		{ FName(TEXT("OwningUserName")), EBuiltInAttributeEOS::OwningUserName },
+		{ FName(TEXT("NumPublicConnections")), EBuiltInAttributeEOS::NumPublicConnections },
+		{ FName(TEXT("NumPrivateConnections")), EBuiltInAttributeEOS::NumPrivateConnections },
+		{ FName(TEXT("bAntiCheatProtected")), EBuiltInAttributeEOS::AntiCheatProtected },
+		{ FName(TEXT("bUsesStats")), EBuiltInAttributeEOS::UsesStats },
+		{ FName(TEXT("bIsDedicated")), EBuiltInAttributeEOS::IsDedicated },
+		{ FName(TEXT("BuildUniqueId")), EBuiltInAttributeEOS::BuildUniqueId }
+	};
+
+	const EBuiltInAttributeEOS* BuiltInAttribute = BuiltInAttributes.Find(Key);
+	return BuiltInAttribute != nullptr ? *BuiltInAttribute : EBuiltInAttributeEOS::None;
+}
+
 struct FAttributeOptions :
 	public EOS_Sessions_AttributeData
 {
@@ -485,6 +545,11 @@ void FOnlineSessionEOS::Init(const FString& InBucketId)
 	LobbyHandle = EOS_Platform_GetLobbyInterface(*EOSSubsystem->EOSPlatformHandle);
 	RegisterLobbyNotifications();
 
+	SessionUpdateMinInterval = UEOSSettings::GetSettings().SessionUpdateMinIntervalInMilliseconds / 1000.0;
+	SearchResultsBudget = UEOSSettings::GetSettings().SessionSearchResultsBudgetInMilliseconds / 1000.0;
+	SearchCacheTTL = UEOSSettings::GetSettings().SessionSearchCacheTTLInMilliseconds / 1000.0;
+	bRevalidateStaleSearches = UEOSSettings::GetSettings().bRevalidateStaleSessionSearches;
+
 	bIsDedicatedServer = IsRunningDedicatedServer();
 	bIsUsingP2PSockets = false;
 	GConfig->GetBool(TEXT("/Script/OnlineSubsystemEOS.NetDriverEOS"), TEXT("bIsUsingP2PSockets"), bIsUsingP2PSockets, GEngineIni);
@@ -501,16 +566,17 @@ FNamedOnlineSession* FOnlineSessionEOS::GetNamedSessionFromLobbyId(const FUnique
 {
 	FNamedOnlineSession* Result = nullptr;
 
-	FScopeLock ScopeLock(&SessionLock);
-	for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
+	FRWScopeLock ScopeLock(SessionLock, SLT_ReadOnly);
+	for (TMultiMap<uint32, FNamedOnlineSession*>::TConstKeyIterator It(LobbySessionsById, GetTypeHash(LobbyId)); It; ++It)
 	{
-		FNamedOnlineSession& Session = Sessions[SearchIndex];
-		if (Session.SessionInfo.IsValid())
+		FNamedOnlineSession* Session = It.Value();
+		if (Session->SessionInfo.IsValid())
 		{
-			FOnlineSessionInfoEOS* SessionInfo = (FOnlineSessionInfoEOS*)Session.SessionInfo.Get();
-			if (!Session.SessionSettings.bIsLANMatch && Session.SessionSettings.bUseLobbiesIfAvailable && *SessionInfo->SessionId == LobbyId)
+			// Ids can share a hash, so make sure it is that lobby
+			FOnlineSessionInfoEOS* SessionInfo = (FOnlineSessionInfoEOS*)Session->SessionInfo.Get();
+			if (!Session->SessionSettings.bIsLANMatch && Session->SessionSettings.bUseLobbiesIfAvailable && *SessionInfo->SessionId == LobbyId)
 			{
-				Result = &Sessions[SearchIndex];
+				Result = Session;
 				break;
 			}
 		}
@@ -519,6 +585,24 @@ FNamedOnlineSession* FOnlineSessionEOS::GetNamedSessionFromLobbyId(const FUnique
 	return Result;
 }
 
+void FOnlineSessionEOS::IndexLobbySession(FNamedOnlineSession* Session)
+{
+	check(Session != nullptr && Session->SessionInfo.IsValid());
+
+	// Hashes the same as the FUniqueNetIdEOS look ups use, which hash the id string
+	const uint32 LobbyIdHash = GetTypeHash(Session->SessionInfo->GetSessionId().ToString());
+
+	FRWScopeLock ScopeLock(SessionLock, SLT_Write);
+	// Joining replaces the session info, so drop whatever lobby the session was indexed under before
+	uint32 PreviousLobbyIdHash = 0;
+	if (LobbyIdHashesByName.RemoveAndCopyValue(Session->SessionName, PreviousLobbyIdHash))
+	{
+		LobbySessionsById.RemoveSingle(PreviousLobbyIdHash, Session);
+	}
+	LobbySessionsById.Add(LobbyIdHash, Session);
+	LobbyIdHashesByName.Add(Session->SessionName, LobbyIdHash);
+}
+
 void FOnlineSessionEOS::RegisterLobbyNotifications()
 {
 	// Lobby data updates
@@ -985,22 +1069,24 @@ uint32 FOnlineSessionEOS::CreateLANSession(int32 HostingPlayerNum, FNamedOnlineS
 	return Result;
 }
 
-void FOnlineSessionEOS::SetPermissionLevel(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session)
+EOS_EOnlineSessionPermissionLevel FOnlineSessionEOS::GetPermissionLevelFromSessionSettings(const FOnlineSessionSettings& SessionSettings)
 {
-	EOS_SessionModification_SetPermissionLevelOptions Options = { };
-	Options.ApiVersion = EOS_SESSIONMODIFICATION_SETPERMISSIONLEVEL_API_LATEST;
-	if (Session->SessionSettings.NumPublicConnections > 0)
-	{
-		Options.PermissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_PublicAdvertised;
-	}
-	else if (Session->SessionSettings.bAllowJoinViaPresence)
+	if (SessionSettings.NumPublicConnections > 0)
 	{
-		Options.PermissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_JoinViaPresence;
+		return EOS_EOnlineSessionPermissionLevel::EOS_OSPF_PublicAdvertised;
 	}
-	else
+	else if (SessionSettings.bAllowJoinViaPresence)
 	{
-		Options.PermissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_InviteOnly;
+		return EOS_EOnlineSessionPermissionLevel::EOS_OSPF_JoinViaPresence;
 	}
+	return EOS_EOnlineSessionPermissionLevel::EOS_OSPF_InviteOnly;
+}
+
+void FOnlineSessionEOS::SetPermissionLevel(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session)
+{
+	EOS_SessionModification_SetPermissionLevelOptions Options = { };
+	Options.ApiVersion = EOS_SESSIONMODIFICATION_SETPERMISSIONLEVEL_API_LATEST;
+	Options.PermissionLevel = GetPermissionLevelFromSessionSettings(Session->SessionSettings);
 
 	UE_LOG_ONLINE_SESSION(Log, TEXT("EOS_SessionModification_SetPermissionLevel() set to (%d)"), (int32)Options.PermissionLevel);
 
@@ -1042,13 +1128,53 @@ void FOnlineSessionEOS::AddAttribute(EOS_HSessionModification SessionModHandle,
 	}
 }
 
-void FOnlineSessionEOS::SetAttributes(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session)
+void FOnlineSessionEOS::RemoveAttribute(EOS_HSessionModification SessionModHandle, FName Key)
 {
-	FAttributeOptions Opt1("NumPrivateConnections", Session->SessionSettings.NumPrivateConnections);
-	AddAttribute(SessionModHandle, &Opt1);
+	EOS_SessionModification_RemoveAttributeOptions Options = { };
+	Options.ApiVersion = EOS_SESSIONMODIFICATION_REMOVEATTRIBUTE_API_LATEST;
+	Options.Key = GetAttributeKey(Key);
+
+	UE_LOG_ONLINE_SESSION(Log, TEXT("EOS_SessionModification_RemoveAttribute() named (%s)"), *Key.ToString());
+
+	EOS_EResult ResultCode = EOS_SessionModification_RemoveAttribute(SessionModHandle, &Options);
+	if (ResultCode != EOS_EResult::EOS_Success)
+	{
+		UE_LOG_ONLINE_SESSION(Error, TEXT("EOS_SessionModification_RemoveAttribute() failed for attribute name (%s) with EOS result code (%s)"), *Key.ToString(), ANSI_TO_TCHAR(EOS_EResult_ToString(ResultCode)));
+	}
+}
 
-	FAttributeOptions Opt2("NumPublicConnections", Session->SessionSettings.NumPublicConnections);
-	AddAttribute(SessionModHandle, &Opt2);
+/** Names of the non attribute settings tracked in FSessionAttributeSetEOS::Properties */
+static const FName PermissionLevelProperty(TEXT("PermissionLevel"));
+static const FName JoinInProgressProperty(TEXT("bAllowJoinInProgress"));
+static const FName MaxMembersProperty(TEXT("MaxMembers"));
+
+/** Whether Value differs from what was last published under Key, or was never published */
+static bool HasAttributeChanged(const TMap<FName, FVariantData>& Published, FName Key, const FVariantData& Value)
+{
+	const FVariantData* PublishedValue = Published.Find(Key);
+	return PublishedValue == nullptr || *PublishedValue != Value;
+}
+
+static bool HasPropertyChanged(const FSessionAttributeSetEOS& AttributeSet, const FSessionAttributeSetEOS& PublishedSet, FName Key)
+{
+	const FVariantData* Value = AttributeSet.Properties.Find(Key);
+	return Value != nullptr && HasAttributeChanged(PublishedSet.Properties, Key, *Value);
+}
+
+void FOnlineSessionEOS::BuildSessionAttributeSet(FNamedOnlineSession* Session, FSessionAttributeSetEOS& OutAttributeSet)
+{
+	static const FName NumPrivateConnectionsName(TEXT("NumPrivateConnections"));
+	static const FName NumPublicConnectionsName(TEXT("NumPublicConnections"));
+	static const FName AntiCheatProtectedName(TEXT("bAntiCheatProtected"));
+	static const FName UsesStatsName(TEXT("bUsesStats"));
+	static const FName IsDedicatedName(TEXT("bIsDedicated"));
+	static const FName BuildUniqueIdName(TEXT("BuildUniqueId"));
+
+	OutAttributeSet.Properties.Add(PermissionLevelProperty, FVariantData((int32)GetPermissionLevelFromSessionSettings(Session->SessionSettings)));
+	OutAttributeSet.Properties.Add(JoinInProgressProperty, FVariantData(Session->SessionSettings.bAllowJoinInProgress));
+
+	OutAttributeSet.Attributes.Add(NumPrivateConnectionsName, FVariantData(Session->SessionSettings.NumPrivateConnections));
+	OutAttributeSet.Attributes.Add(NumPublicConnectionsName, FVariantData(Session->SessionSettings.NumPublicConnections));
 
 	// Handle auto generation of dedicated server names
 	if (Session->OwningUserName.IsEmpty())
@@ -1068,22 +1194,14 @@ void FOnlineSessionEOS::SetAttributes(EOS_HSessionModification SessionModHandle,
 		Session->OwningUserName = OwningPlayerName;
 	}
 
-	FAttributeOptions Opt5("bAntiCheatProtected", Session->SessionSettings.bAntiCheatProtected);
-	AddAttribute(SessionModHandle, &Opt5);
-
-	FAttributeOptions Opt6("bUsesStats", Session->SessionSettings.bUsesStats);
-	AddAttribute(SessionModHandle, &Opt6);
-
-	FAttributeOptions Opt7("bIsDedicated", Session->SessionSettings.bIsDedicated);
-	AddAttribute(SessionModHandle, &Opt7);
-
-	FAttributeOptions Opt8("BuildUniqueId", Session->SessionSettings.BuildUniqueId);
-	AddAttribute(SessionModHandle, &Opt8);
+	OutAttributeSet.Attributes.Add(AntiCheatProtectedName, FVariantData(Session->SessionSettings.bAntiCheatProtected));
+	OutAttributeSet.Attributes.Add(UsesStatsName, FVariantData(Session->SessionSettings.bUsesStats));
+	OutAttributeSet.Attributes.Add(IsDedicatedName, FVariantData(Session->SessionSettings.bIsDedicated));
+	OutAttributeSet.Attributes.Add(BuildUniqueIdName, FVariantData(Session->SessionSettings.BuildUniqueId));
 
 	// Add all of the session settings
 	for (FSessionSettings::TConstIterator It(Session->SessionSettings.Settings); It; ++It)
 	{
-		const FName KeyName = It.Key();
 		const FOnlineSessionSetting& Setting = It.Value();
 
 		// Skip unsupported types or non session advertised settings
@@ -1092,8 +1210,28 @@ void FOnlineSessionEOS::SetAttributes(EOS_HSessionModification SessionModHandle,
 			continue;
 		}
 
-		FAttributeOptions Attribute(TCHAR_TO_UTF8(*KeyName.ToString()), Setting.Data);
-		AddAttribute(SessionModHandle, &Attribute);
+		OutAttributeSet.Attributes.Add(It.Key(), Setting.Data);
+	}
+}
+
+void FOnlineSessionEOS::SetAttributes(EOS_HSessionModification SessionModHandle, const FSessionAttributeSetEOS& AttributeSet, const FSessionAttributeSetEOS& PublishedSet)
+{
+	for (const TPair<FName, FVariantData>& Pair : AttributeSet.Attributes)
+	{
+		if (HasAttributeChanged(PublishedSet.Attributes, Pair.Key, Pair.Value))
+		{
+			FAttributeOptions Attribute(GetAttributeKey(Pair.Key), Pair.Value);
+			AddAttribute(SessionModHandle, &Attribute);
+		}
+	}
+
+	// Settings that were advertised before but no longer are
+	for (const TPair<FName, FVariantData>& Pair : PublishedSet.Attributes)
+	{
+		if (!AttributeSet.Attributes.Contains(Pair.Key))
+		{
+			RemoveAttribute(SessionModHandle, Pair.Key);
+		}
 	}
 }
 
@@ -1213,6 +1351,11 @@ uint32 FOnlineSessionEOS::CreateEOSSession(int32 HostingPlayerNum, FNamedOnlineS
 	}
 	Session->SessionInfo = MakeShareable(new FOnlineSessionInfoEOS(HostAddr, FUniqueNetIdEOS::EmptyId(), nullptr));
 
+	// A new session has nothing published yet, so everything goes out
+	PublishedAttributeSets.Remove(Session->SessionName);
+	FSessionAttributeSetEOS AttributeSet;
+	BuildSessionAttributeSet(Session, AttributeSet);
+
 	FUpdateSessionCallback* CallbackObj = new FUpdateSessionCallback();
 	CallbackObj->CallbackLambda = [this, Session](const EOS_Sessions_UpdateSessionCallbackInfo* Data)
 	{
@@ -1227,22 +1370,34 @@ uint32 FOnlineSessionEOS::CreateEOSSession(int32 HostingPlayerNum, FNamedOnlineS
 		else
 		{
 			Session->SessionState = EOnlineSessionState::NoSession;
+			PublishedAttributeSets.Remove(Session->SessionName);
 			UE_LOG_ONLINE_SESSION(Error, TEXT("EOS_Sessions_UpdateSession() failed with EOS result code (%s)"), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
 		}
 		TriggerOnCreateSessionCompleteDelegates(Session->SessionName, bWasSuccessful);
 	};
 
-	return SharedSessionUpdate(SessionModHandle, Session, CallbackObj);
+	return SharedSessionUpdate(SessionModHandle, Session, AttributeSet, CallbackObj);
 }
 
-uint32 FOnlineSessionEOS::SharedSessionUpdate(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session, FUpdateSessionCallback* Callback)
+uint32 FOnlineSessionEOS::SharedSessionUpdate(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session, const FSessionAttributeSetEOS& AttributeSet, FUpdateSessionCallback* Callback)
 {
+	// Only send what changed since the last update. Assume it lands; a failed update forgets the published set
+	FSessionAttributeSetEOS& PublishedSet = PublishedAttributeSets.FindOrAdd(Session->SessionName);
+
 	// Set invite flags
-	SetPermissionLevel(SessionModHandle, Session);
+	if (HasPropertyChanged(AttributeSet, PublishedSet, PermissionLevelProperty))
+	{
+		SetPermissionLevel(SessionModHandle, Session);
+	}
 	// Set JIP flag
-	SetJoinInProgress(SessionModHandle, Session);
+	if (HasPropertyChanged(AttributeSet, PublishedSet, JoinInProgressProperty))
+	{
+		SetJoinInProgress(SessionModHandle, Session);
+	}
 	// Add any attributes for filtering by searchers
-	SetAttributes(SessionModHandle, Session);
+	SetAttributes(SessionModHandle, AttributeSet, PublishedSet);
+
+	PublishedSet = AttributeSet;
 
 	// Commit the session changes
 	EOS_Sessions_UpdateSessionOptions CreateOptions = { };
@@ -1351,17 +1506,14 @@ bool FOnlineSessionEOS::UpdateSession(FName SessionName, FOnlineSessionSettings&
 
 		if (!Session->SessionSettings.bIsLANMatch)
 		{
-			if (Session->SessionSettings.bUseLobbiesIfAvailable)
-			{
-				Result = UpdateLobbySession(Session);
-			}
-			else
-			{
-				Result = UpdateEOSSession(Session);
-			}
+			// Merged with any other updates to this session, the delegate fires once per call when it completes
+			QueueSessionUpdate(SessionName);
+			return true;
 		}
 		else
 		{
+			// The next beacon response needs to carry the new settings
+			LanResponsePackets.Remove(SessionName);
 			Result = ONLINE_SUCCESS;
 		}
 	}
@@ -1370,15 +1522,128 @@ bool FOnlineSessionEOS::UpdateSession(FName SessionName, FOnlineSessionSettings&
 		UE_LOG_ONLINE_SESSION(Warning, TEXT("No session (%s) found for update!"), *SessionName.ToString());
 	}
 
-	if (Result != ONLINE_IO_PENDING)
+	EOSSubsystem->ExecuteNextTick([this, SessionName, Result]()
+		{
+			TriggerOnUpdateSessionCompleteDelegates(SessionName, Result == ONLINE_SUCCESS);
+		});
+
+	return true;
+}
+
+void FOnlineSessionEOS::QueueSessionUpdate(FName SessionName)
+{
+	FSessionUpdateStateEOS& UpdateState = SessionUpdateStates.FindOrAdd(SessionName);
+	UpdateState.NumQueuedCallers++;
+
+	// Otherwise it goes out from TickSessionUpdates once the one in flight is done and the interval has passed
+	if (!UpdateState.bInFlight && FPlatformTime::Seconds() - UpdateState.LastSendTime >= SessionUpdateMinInterval)
+	{
+		DispatchSessionUpdate(SessionName, UpdateState);
+	}
+}
+
+void FOnlineSessionEOS::DispatchSessionUpdate(FName SessionName, FSessionUpdateStateEOS& UpdateState)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session == nullptr)
+	{
+		UE_LOG_ONLINE_SESSION(Warning, TEXT("Session (%s) went away with %d updates queued"), *SessionName.ToString(), UpdateState.NumQueuedCallers);
+
+		const int32 NumCallers = UpdateState.NumQueuedCallers;
+		SessionUpdateStates.Remove(SessionName);
+		for (int32 Index = 0; Index < NumCallers; Index++)
+		{
+			TriggerOnUpdateSessionCompleteDelegates(SessionName, false);
+		}
+		return;
+	}
+
+	// Stays queued until the session exists on the backend
+	if (Session->SessionState == EOnlineSessionState::Creating)
+	{
+		return;
+	}
+
+	UpdateState.NumInFlightCallers = UpdateState.NumQueuedCallers;
+	UpdateState.NumQueuedCallers = 0;
+	UpdateState.bInFlight = true;
+
+	uint32 Result = ONLINE_FAIL;
+	if (Session->SessionSettings.bUseLobbiesIfAvailable)
+	{
+		Result = UpdateLobbySession(Session);
+	}
+	else
+	{
+		Result = UpdateEOSSession(Session);
+	}
+
+	if (Result == ONLINE_IO_PENDING)
+	{
+		UpdateState.LastSendTime = FPlatformTime::Seconds();
+	}
+	else
 	{
 		EOSSubsystem->ExecuteNextTick([this, SessionName, Result]()
 			{
-				TriggerOnUpdateSessionCompleteDelegates(SessionName, Result == ONLINE_SUCCESS);
+				OnSessionUpdateComplete(SessionName, Result == ONLINE_SUCCESS);
 			});
 	}
+}
 
-	return true;
+void FOnlineSessionEOS::TickSessionUpdates()
+{
+	if (SessionUpdateStates.Num() == 0)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	TArray<FName, TInlineAllocator<4>> ReadySessions;
+	for (TMap<FName, FSessionUpdateStateEOS>::TIterator It(SessionUpdateStates); It; ++It)
+	{
+		const FSessionUpdateStateEOS& UpdateState = It.Value();
+		if (UpdateState.bInFlight || Now - UpdateState.LastSendTime < SessionUpdateMinInterval)
+		{
+			continue;
+		}
+
+		if (UpdateState.NumQueuedCallers > 0)
+		{
+			ReadySessions.Add(It.Key());
+		}
+		else
+		{
+			// Idle and past its interval, so there is nothing left to remember
+			It.RemoveCurrent();
+		}
+	}
+
+	// Dispatching can remove states, so don't do it while iterating them
+	for (FName SessionName : ReadySessions)
+	{
+		if (FSessionUpdateStateEOS* UpdateState = SessionUpdateStates.Find(SessionName))
+		{
+			DispatchSessionUpdate(SessionName, *UpdateState);
+		}
+	}
+}
+
+void FOnlineSessionEOS::OnSessionUpdateComplete(FName SessionName, bool bWasSuccessful)
+{
+	// Updates we start ourselves, like the first one of a new lobby, still notify once
+	int32 NumCallers = 1;
+	if (FSessionUpdateStateEOS* UpdateState = SessionUpdateStates.Find(SessionName))
+	{
+		NumCallers = FMath::Max(UpdateState->NumInFlightCallers, 1);
+		UpdateState->NumInFlightCallers = 0;
+		UpdateState->bInFlight = false;
+	}
+
+	for (int32 Index = 0; Index < NumCallers; Index++)
+	{
+		TriggerOnUpdateSessionCompleteDelegates(SessionName, bWasSuccessful);
+	}
 }
 
 struct FSessionUpdateOptions :
@@ -1398,6 +1663,17 @@ uint32 FOnlineSessionEOS::UpdateEOSSession(FNamedOnlineSession* Session)
 		return ONLINE_IO_PENDING;
 	}
 
+	FSessionAttributeSetEOS AttributeSet;
+	BuildSessionAttributeSet(Session, AttributeSet);
+
+	// Don't spend an update on a session the backend already has the latest of
+	const FSessionAttributeSetEOS* PublishedSet = PublishedAttributeSets.Find(Session->SessionName);
+	if (PublishedSet != nullptr && *PublishedSet == AttributeSet)
+	{
+		UE_LOG_ONLINE_SESSION(Verbose, TEXT("Skipping update of session (%s) as nothing changed since it was last published"), *Session->SessionName.ToString());
+		return ONLINE_SUCCESS;
+	}
+
 	EOS_HSessionModification SessionModHandle = NULL;
 	FSessionUpdateOptions Options(TCHAR_TO_UTF8(*Session->SessionName.ToString()));
 
@@ -1415,12 +1691,13 @@ uint32 FOnlineSessionEOS::UpdateEOSSession(FNamedOnlineSession* Session)
 		if (!bWasSuccessful)
 		{
 			Session->SessionState = EOnlineSessionState::NoSession;
+			PublishedAttributeSets.Remove(Session->SessionName);
 			UE_LOG_ONLINE_SESSION(Error, TEXT("EOS_Sessions_UpdateSession() failed with EOS result code (%s)"), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
 		}
-		TriggerOnUpdateSessionCompleteDelegates(Session->SessionName, bWasSuccessful);
+		OnSessionUpdateComplete(Session->SessionName, bWasSuccessful);
 	};
 
-	return SharedSessionUpdate(SessionModHandle, Session, CallbackObj);
+	return SharedSessionUpdate(SessionModHandle, Session, AttributeSet, CallbackObj);
 }
 
 bool FOnlineSessionEOS::EndSession(FName SessionName)
@@ -1712,6 +1989,21 @@ bool FOnlineSessionEOS::CancelMatchmaking(const FUniqueNetId& SearchingPlayerId,
 	return true;
 }
 
+/** Builds the key searches share cached results under: the bucket, the result limit and the query params in a fixed order */
+static FString MakeSessionSearchCacheKey(const FOnlineSessionSearch& SearchSettings)
+{
+	TArray<FString> Params;
+	for (FSearchParams::TConstIterator It(SearchSettings.QuerySettings.SearchParams); It; ++It)
+	{
+		const FOnlineSessionSearchParam& SearchParam = It.Value();
+		Params.Add(FString::Printf(TEXT("%s %s %s:%s"), *It.Key().ToString(), EOnlineComparisonOp::ToString(SearchParam.ComparisonOp), EOnlineKeyValuePairDataType::ToString(SearchParam.Data.GetType()), *SearchParam.Data.ToString()));
+	}
+	// The params are a map, so the same query can come in any order
+	Params.Sort();
+
+	return FString::Printf(TEXT("%s;%d;%s"), UTF8_TO_TCHAR(BucketIdAnsi), SearchSettings.MaxSearchResults, *FString::Join(Params, TEXT(";")));
+}
+
 bool FOnlineSessionEOS::FindSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
 {
 	uint32 Return = ONLINE_FAIL;
@@ -1722,23 +2014,15 @@ bool FOnlineSessionEOS::FindSessions(int32 SearchingPlayerNum, const TSharedRef<
 		// LAN searching uses this as an approximation for ping so make sure to set it
 		SessionSearchStartInSeconds = FPlatformTime::Seconds();
 
-		// Free up previous results
-		SearchSettings->SearchResults.Empty();
+		// Free up previous results, keeping the array's memory for the new ones
+		SearchSettings->SearchResults.Reset();
 		// Copy the search pointer so we can keep it around
 		CurrentSessionSearch = SearchSettings;
 
 		// Check if its a LAN query
 		if (!SearchSettings->bIsLanQuery)
 		{
-			bool bUssLobbiesIfAvailable = false;
-			if (SearchSettings->QuerySettings.Get(SEARCH_LOBBIES, bUssLobbiesIfAvailable) && bUssLobbiesIfAvailable)
-			{
-				Return = FindLobbySession(SearchingPlayerNum, SearchSettings);
-			}
-			else
-			{
-				Return = FindEOSSession(SearchingPlayerNum, SearchSettings);
-			}
+			Return = SearchCacheTTL > 0.0 ? FindCachedSessions(SearchingPlayerNum, SearchSettings) : StartBackendSearch(SearchingPlayerNum, SearchSettings);
 		}
 		else
 		{
@@ -1759,6 +2043,173 @@ bool FOnlineSessionEOS::FindSessions(int32 SearchingPlayerNum, const TSharedRef<
 	return Return == ONLINE_SUCCESS || Return == ONLINE_IO_PENDING;
 }
 
+uint32 FOnlineSessionEOS::StartBackendSearch(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	bool bUssLobbiesIfAvailable = false;
+	if (SearchSettings->QuerySettings.Get(SEARCH_LOBBIES, bUssLobbiesIfAvailable) && bUssLobbiesIfAvailable)
+	{
+		return FindLobbySession(SearchingPlayerNum, SearchSettings);
+	}
+	return FindEOSSession(SearchingPlayerNum, SearchSettings);
+}
+
+uint32 FOnlineSessionEOS::FindCachedSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	const FString CacheKey = MakeSessionSearchCacheKey(*SearchSettings);
+	FSessionSearchCacheEntryEOS& Entry = SessionSearchCache.FindOrAdd(CacheKey);
+
+	if (Entry.PendingSearch.IsValid())
+	{
+		// The same query is already with the backend, so wait for its results instead of asking again
+		if (Entry.PendingSearch.Get() != &SearchSettings.Get())
+		{
+			Entry.Waiters.AddUnique(SearchSettings);
+		}
+		UE_LOG_ONLINE_SESSION(Verbose, TEXT("Sharing the results of a search already in progress (%s)"), *CacheKey);
+		return ONLINE_IO_PENDING;
+	}
+
+	if (Entry.bHasResults)
+	{
+		const double Age = FPlatformTime::Seconds() - Entry.FetchTime;
+		if (Age < SearchCacheTTL || bRevalidateStaleSearches)
+		{
+			UE_LOG_ONLINE_SESSION(Verbose, TEXT("Returning %d cached search results, %.1f seconds old (%s)"), Entry.SearchResults.Num(), Age, *CacheKey);
+
+			SearchSettings->SearchResults = Entry.SearchResults;
+			EOSSubsystem->ExecuteNextTick([this, SearchSettings]()
+				{
+					// Unless it was cancelled in the meantime
+					if (SearchSettings->SearchState == EOnlineAsyncTaskState::InProgress)
+					{
+						SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
+						if (SearchSettings->SearchResults.Num() > 0)
+						{
+							TriggerOnFindSessionsPageReceivedDelegates(SearchSettings, 0);
+						}
+						TriggerOnFindSessionsCompleteDelegates(true);
+					}
+				});
+
+			if (Age >= SearchCacheTTL)
+			{
+				// Refresh the stale results for whoever asks next, using a search of our own so nothing is notified
+				TSharedRef<FOnlineSessionSearch> RefreshSearch = MakeShared<FOnlineSessionSearch>();
+				RefreshSearch->QuerySettings = SearchSettings->QuerySettings;
+				RefreshSearch->MaxSearchResults = SearchSettings->MaxSearchResults;
+				if (StartBackendSearch(SearchingPlayerNum, RefreshSearch) == ONLINE_IO_PENDING)
+				{
+					RefreshSearch->SearchState = EOnlineAsyncTaskState::InProgress;
+					Entry.PendingSearch = RefreshSearch;
+					Entry.bIsRevalidating = true;
+				}
+			}
+			return ONLINE_IO_PENDING;
+		}
+	}
+
+	uint32 Return = StartBackendSearch(SearchingPlayerNum, SearchSettings);
+	if (Return == ONLINE_IO_PENDING)
+	{
+		bool bUseLobbies = false;
+		Entry.PendingSearch = SearchSettings;
+		Entry.bIsRevalidating = false;
+		Entry.bIsLobbySearch = SearchSettings->QuerySettings.Get(SEARCH_LOBBIES, bUseLobbies) && bUseLobbies;
+	}
+	else if (!Entry.bHasResults)
+	{
+		SessionSearchCache.Remove(CacheKey);
+	}
+	return Return;
+}
+
+void FOnlineSessionEOS::OnBackendSearchComplete(const TSharedRef<FOnlineSessionSearch>& SearchSettings, bool bWasSuccessful, bool bWasCancelled)
+{
+	bool bShouldNotify = !bWasCancelled;
+	TArray<TSharedRef<FOnlineSessionSearch>> Waiters;
+
+	for (TMap<FString, FSessionSearchCacheEntryEOS>::TIterator It(SessionSearchCache); It; ++It)
+	{
+		FSessionSearchCacheEntryEOS& Entry = It.Value();
+		if (Entry.PendingSearch.Get() != &SearchSettings.Get())
+		{
+			continue;
+		}
+
+		// Background refreshes have nobody of their own to tell
+		bShouldNotify &= !Entry.bIsRevalidating;
+		Waiters = MoveTemp(Entry.Waiters);
+		Entry.Waiters.Reset();
+		Entry.PendingSearch.Reset();
+		Entry.bIsRevalidating = false;
+
+		if (bWasSuccessful)
+		{
+			Entry.SearchResults = SearchSettings->SearchResults;
+			Entry.bHasResults = true;
+			Entry.FetchTime = FPlatformTime::Seconds();
+		}
+		else if (!bWasCancelled || !Entry.bHasResults)
+		{
+			// Don't keep handing out results the backend would no longer give us
+			It.RemoveCurrent();
+		}
+		break;
+	}
+
+	// Notify last, since the delegates may well search again
+	if (bShouldNotify)
+	{
+		TriggerOnFindSessionsCompleteDelegates(bWasSuccessful);
+	}
+
+	for (const TSharedRef<FOnlineSessionSearch>& Waiter : Waiters)
+	{
+		if (Waiter->SearchState != EOnlineAsyncTaskState::InProgress)
+		{
+			continue;
+		}
+
+		if (bWasSuccessful)
+		{
+			Waiter->SearchResults = SearchSettings->SearchResults;
+			Waiter->SearchState = EOnlineAsyncTaskState::Done;
+			if (Waiter->SearchResults.Num() > 0)
+			{
+				TriggerOnFindSessionsPageReceivedDelegates(Waiter, 0);
+			}
+		}
+		else
+		{
+			Waiter->SearchState = EOnlineAsyncTaskState::Failed;
+		}
+		TriggerOnFindSessionsCompleteDelegates(bWasSuccessful);
+	}
+}
+
+void FOnlineSessionEOS::RemoveCachedLobbySearches()
+{
+	for (TMap<FString, FSessionSearchCacheEntryEOS>::TIterator It(SessionSearchCache); It; ++It)
+	{
+		FSessionSearchCacheEntryEOS& Entry = It.Value();
+		if (!Entry.bIsLobbySearch)
+		{
+			continue;
+		}
+
+		if (Entry.PendingSearch.IsValid())
+		{
+			// The search in flight will bring its own details handles
+			Entry.SearchResults.Empty();
+			Entry.bHasResults = false;
+		}
+		else
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 bool FOnlineSessionEOS::FindSessions(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
 {
 	// This function doesn't use the SearchingPlayerNum parameter, so passing in anything is fine.
@@ -1870,6 +2321,7 @@ void FOnlineSessionEOS::CopyAttributes(EOS_HSessionDetails SessionHandle, FOnlin
 	EOS_SessionDetails_GetSessionAttributeCountOptions CountOptions = { };
 	CountOptions.ApiVersion = EOS_SESSIONDETAILS_GETSESSIONATTRIBUTECOUNT_API_LATEST;
 	int32 Count = EOS_SessionDetails_GetSessionAttributeCount(SessionHandle, &CountOptions);
+	OutSession.SessionSettings.Settings.Reserve(Count);
 
 	for (int32 Index = 0; Index < Count; Index++)
 	{
@@ -1881,61 +2333,71 @@ void FOnlineSessionEOS::CopyAttributes(EOS_HSessionDetails SessionHandle, FOnlin
 		EOS_EResult ResultCode = EOS_SessionDetails_CopySessionAttributeByIndex(SessionHandle, &AttrOptions, &Attribute);
 		if (ResultCode == EOS_EResult::EOS_Success)
 		{
-			FString Key = Attribute->Data->Key;
-			if (Key == TEXT("NumPublicConnections"))
-			{
-				// Adjust the public connections based upon this
-				OutSession.SessionSettings.NumPublicConnections = Attribute->Data->Value.AsInt64;
-			}
-			else if (Key == TEXT("NumPrivateConnections"))
-			{
-				// Adjust the private connections based upon this
-				OutSession.SessionSettings.NumPrivateConnections = Attribute->Data->Value.AsInt64;
-			}
-			else if (Key == TEXT("bAntiCheatProtected"))
-			{
-				OutSession.SessionSettings.bAntiCheatProtected = Attribute->Data->Value.AsBool == EOS_TRUE;
-			}
-			else if (Key == TEXT("bUsesStats"))
-			{
-				OutSession.SessionSettings.bUsesStats = Attribute->Data->Value.AsBool == EOS_TRUE;
-			}
-			else if (Key == TEXT("bIsDedicated"))
-			{
-				OutSession.SessionSettings.bIsDedicated = Attribute->Data->Value.AsBool == EOS_TRUE;
-			}
-			else if (Key == TEXT("BuildUniqueId"))
-			{
-				OutSession.SessionSettings.BuildUniqueId = Attribute->Data->Value.AsInt64;
-			}
-			// Handle FOnlineSessionSetting settings
-			else
+			const FName Key(UTF8_TO_TCHAR(Attribute->Data->Key));
+			switch (GetBuiltInAttribute(Key))
 			{
-				FOnlineSessionSetting Setting;
-				switch (Attribute->Data->ValueType)
+				case EBuiltInAttributeEOS::NumPublicConnections:
 				{
-					case EOS_ESessionAttributeType::EOS_SAT_Boolean:
-					{
-						Setting.Data.SetValue(Attribute->Data->Value.AsBool == EOS_TRUE);
-						break;
-					}
-					case EOS_ESessionAttributeType::EOS_SAT_Int64:
-					{
-						Setting.Data.SetValue(int64(Attribute->Data->Value.AsInt64));
-						break;
-					}
-					case EOS_ESessionAttributeType::EOS_SAT_Double:
-					{
-						Setting.Data.SetValue(Attribute->Data->Value.AsDouble);
-						break;
-					}
-					case EOS_ESessionAttributeType::EOS_SAT_String:
+					// Adjust the public connections based upon this
+					OutSession.SessionSettings.NumPublicConnections = Attribute->Data->Value.AsInt64;
+					break;
+				}
+				case EBuiltInAttributeEOS::NumPrivateConnections:
+				{
+					// Adjust the private connections based upon this
+					OutSession.SessionSettings.NumPrivateConnections = Attribute->Data->Value.AsInt64;
+					break;
+				}
+				case EBuiltInAttributeEOS::AntiCheatProtected:
+				{
+					OutSession.SessionSettings.bAntiCheatProtected = Attribute->Data->Value.AsBool == EOS_TRUE;
+					break;
+				}
+				case EBuiltInAttributeEOS::UsesStats:
+				{
+					OutSession.SessionSettings.bUsesStats = Attribute->Data->Value.AsBool == EOS_TRUE;
+					break;
+				}
+				case EBuiltInAttributeEOS::IsDedicated:
+				{
+					OutSession.SessionSettings.bIsDedicated = Attribute->Data->Value.AsBool == EOS_TRUE;
+					break;
+				}
+				case EBuiltInAttributeEOS::BuildUniqueId:
+				{
+					OutSession.SessionSettings.BuildUniqueId = Attribute->Data->Value.AsInt64;
+					break;
+				}
+				// Handle FOnlineSessionSetting settings, including the owner ones only lobbies publish
+				default:
+				{
+					FOnlineSessionSetting Setting;
+					switch (Attribute->Data->ValueType)
 					{
-						Setting.Data.SetValue(ANSI_TO_TCHAR(Attribute->Data->Value.AsUtf8));
-						break;
+						case EOS_ESessionAttributeType::EOS_SAT_Boolean:
+						{
+							Setting.Data.SetValue(Attribute->Data->Value.AsBool == EOS_TRUE);
+							break;
+						}
+						case EOS_ESessionAttributeType::EOS_SAT_Int64:
+						{
+							Setting.Data.SetValue(int64(Attribute->Data->Value.AsInt64));
+							break;
+						}
+						case EOS_ESessionAttributeType::EOS_SAT_Double:
+						{
+							Setting.Data.SetValue(Attribute->Data->Value.AsDouble);
+							break;
+						}
+						case EOS_ESessionAttributeType::EOS_SAT_String:
+						{
+							Setting.Data.SetValue(ANSI_TO_TCHAR(Attribute->Data->Value.AsUtf8));
+							break;
+						}
 					}
+					OutSession.SessionSettings.Settings.Add(Key, Setting);
+					break;
 				}
-				OutSession.SessionSettings.Settings.Add(FName(Key), Setting);
 			}
 		}
 
@@ -1954,7 +2416,7 @@ void FOnlineSessionEOS::AddSearchResult(EOS_HSessionDetails SessionHandle, const
 		int32 Position = SearchSettings->SearchResults.AddZeroed();
 		FOnlineSessionSearchResult& SearchResult = SearchSettings->SearchResults[Position];
 		// This will set the host address and port
-		SearchResult.Session.SessionInfo = MakeShareable(new FOnlineSessionInfoEOS(SessionInfo->HostAddress, SessionInfo->SessionId, SessionHandle));
+		SearchResult.Session.SessionInfo = MakeShared<FOnlineSessionInfoEOS>(SessionInfo->HostAddress, SessionInfo->SessionId, SessionHandle);
 
 		CopySearchResult(SessionHandle, SessionInfo, SearchResult.Session);
 
@@ -1964,6 +2426,112 @@ void FOnlineSessionEOS::AddSearchResult(EOS_HSessionDetails SessionHandle, const
 
 typedef TEOSCallback<EOS_SessionSearch_OnFindCallback, EOS_SessionSearch_FindCallbackInfo> FFindSessionsCallback;
 
+void FOnlineSessionEOS::StartSearchResultsStream(FSearchResultsStreamEOS&& Stream)
+{
+	// Other searches keep their streams, only an earlier run of this same search is replaced
+	const TUniquePtr<FSearchResultsStreamEOS>* OldStream = SearchResultsStreams.FindByPredicate([&Stream](const TUniquePtr<FSearchResultsStreamEOS>& Entry) { return Entry->SearchSettings == Stream.SearchSettings; });
+	if (OldStream != nullptr)
+	{
+		FinishSearchResultsStream(OldStream->Get(), false);
+	}
+
+	FSearchResultsStreamEOS* NewStream = SearchResultsStreams.Add_GetRef(MakeUnique<FSearchResultsStreamEOS>(MoveTemp(Stream))).Get();
+
+	// Searches don't know whether the cache started them as a refresh, so look it up once rather than every batch
+	for (const TPair<FString, FSessionSearchCacheEntryEOS>& Pair : SessionSearchCache)
+	{
+		if (Pair.Value.PendingSearch == NewStream->SearchSettings)
+		{
+			NewStream->bSilent = Pair.Value.bIsRevalidating;
+			break;
+		}
+	}
+
+	// Size the results for the whole search now, rather than growing them batch by batch
+	FOnlineSessionSearch& SearchSettings = *NewStream->SearchSettings;
+	SearchSettings.SearchResults.Reserve(SearchSettings.SearchResults.Num() + NewStream->NumResults);
+
+	// Deliver the first page right away rather than a tick later
+	ConvertSearchResultsBatch(NewStream, FPlatformTime::Seconds());
+}
+
+void FOnlineSessionEOS::ConvertSearchResultsBatch(FSearchResultsStreamEOS* Stream, double StartTime)
+{
+	const int32 FirstNewResult = Stream->SearchSettings->SearchResults.Num();
+
+	// Always convert at least one result, even with a budget too small for it
+	int32 NumConverted = 0;
+	while (Stream->NextResult < Stream->NumResults && (NumConverted == 0 || SearchResultsBudget <= 0.0 || FPlatformTime::Seconds() - StartTime < SearchResultsBudget))
+	{
+		Stream->ConvertResult(Stream->NextResult++);
+		NumConverted++;
+	}
+
+	const TSharedRef<FOnlineSessionSearch> SearchSettings = Stream->SearchSettings.ToSharedRef();
+	const bool bIsDone = Stream->NextResult >= Stream->NumResults;
+	if (!Stream->bSilent && SearchSettings->SearchResults.Num() > FirstNewResult)
+	{
+		// May well finish or restart searches, so the stream isn't touched after this
+		TriggerOnFindSessionsPageReceivedDelegates(SearchSettings, FirstNewResult);
+	}
+
+	if (bIsDone)
+	{
+		FinishSearchResultsStream(Stream, true);
+	}
+}
+
+void FOnlineSessionEOS::FinishSearchResultsStream(FSearchResultsStreamEOS* Stream, bool bCompleted)
+{
+	const int32 Index = SearchResultsStreams.IndexOfByPredicate([Stream](const TUniquePtr<FSearchResultsStreamEOS>& Entry) { return Entry.Get() == Stream; });
+	if (Index == INDEX_NONE)
+	{
+		// Already finished from one of its own delegates
+		return;
+	}
+
+	// Remove the stream before completing, in case the completion delegate starts another search
+	TUniquePtr<FSearchResultsStreamEOS> FinishedStream = MoveTemp(SearchResultsStreams[Index]);
+	SearchResultsStreams.RemoveAt(Index);
+	FinishedStream->OnFinished(bCompleted);
+}
+
+void FOnlineSessionEOS::TickSearchResultsStreams()
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Oldest first. Delegates fired along the way can add or finish streams, so walk a snapshot
+	TArray<FSearchResultsStreamEOS*, TInlineAllocator<4>> Streams;
+	for (const TUniquePtr<FSearchResultsStreamEOS>& Stream : SearchResultsStreams)
+	{
+		Streams.Add(Stream.Get());
+	}
+
+	for (int32 Index = 0; Index < Streams.Num(); Index++)
+	{
+		FSearchResultsStreamEOS* Stream = Streams[Index];
+		if (!SearchResultsStreams.ContainsByPredicate([Stream](const TUniquePtr<FSearchResultsStreamEOS>& Entry) { return Entry.Get() == Stream; }))
+		{
+			continue;
+		}
+
+		if (Stream->SearchSettings->SearchState != EOnlineAsyncTaskState::InProgress)
+		{
+			// Cancelled since the last batch, so stop converting results nobody is waiting for
+			FinishSearchResultsStream(Stream, false);
+			continue;
+		}
+
+		// The oldest stream always makes progress, the rest share whatever budget it left
+		if (Index > 0 && SearchResultsBudget > 0.0 && FPlatformTime::Seconds() - StartTime >= SearchResultsBudget)
+		{
+			continue;
+		}
+
+		ConvertSearchResultsBatch(Stream, StartTime);
+	}
+}
+
 uint32 FOnlineSessionEOS::FindEOSSession(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
 {
 	EOS_HSessionSearch SearchHandle = nullptr;
@@ -1977,8 +2545,8 @@ uint32 FOnlineSessionEOS::FindEOSSession(int32 SearchingPlayerNum, const TShared
 		UE_LOG_ONLINE_SESSION(Error, TEXT("EOS_Sessions_CreateSessionSearch() failed with EOS result code (%s)"), ANSI_TO_TCHAR(EOS_EResult_ToString(ResultCode)));
 		return ONLINE_FAIL;
 	}
-	// Store our search handle for use/cleanup later
-	CurrentSearchHandle = MakeShareable(new FSessionSearchEOS(SearchHandle));
+	// Owned by this search's callbacks, so searches running side by side (e.g. a cache refresh) each keep their own
+	TSharedPtr<FSessionSearchEOS> SearchHandleWrapper = MakeShareable(new FSessionSearchEOS(SearchHandle));
 
 	FAttributeOptions Opt1("NumPublicConnections", 1);
 	AddSearchAttribute(SearchHandle, &Opt1, EOS_EOnlineComparisonOp::EOS_OCO_GREATERTHANOREQUAL);
@@ -2000,41 +2568,53 @@ uint32 FOnlineSessionEOS::FindEOSSession(int32 SearchingPlayerNum, const TShared
 #if UE_BUILD_DEBUG
 		UE_LOG_ONLINE_SESSION(Log, TEXT("Adding search param named (%s), (%s)"), *Key.ToString(), *SearchParam.ToString());
 #endif
-		FString ParamName(TEXT("FOSS=") + Key.ToString());
-		FAttributeOptions Attribute(TCHAR_TO_UTF8(*ParamName), SearchParam.Data);
+		FAttributeOptions Attribute(GetSearchAttributeKey(Key), SearchParam.Data);
 		AddSearchAttribute(SearchHandle, &Attribute, ToEOSSearchOp(SearchParam.ComparisonOp));
 	}
 
 	FFindSessionsCallback* CallbackObj = new FFindSessionsCallback();
-	CallbackObj->CallbackLambda = [this, SearchSettings](const EOS_SessionSearch_FindCallbackInfo* Data)
+	CallbackObj->CallbackLambda = [this, SearchSettings, SearchHandleWrapper](const EOS_SessionSearch_FindCallbackInfo* Data)
 	{
 		bool bWasSuccessful = Data->ResultCode == EOS_EResult::EOS_Success;
 		if (bWasSuccessful)
 		{
 			EOS_SessionSearch_GetSearchResultCountOptions SearchResultOptions = { };
 			SearchResultOptions.ApiVersion = EOS_SESSIONSEARCH_GETSEARCHRESULTCOUNT_API_LATEST;
-			int32 NumSearchResults = EOS_SessionSearch_GetSearchResultCount(CurrentSearchHandle->SearchHandle, &SearchResultOptions);
 
-			EOS_SessionSearch_CopySearchResultByIndexOptions IndexOptions = { };
-			IndexOptions.ApiVersion = EOS_SESSIONSEARCH_COPYSEARCHRESULTBYINDEX_API_LATEST;
-			for (int32 Index = 0; Index < NumSearchResults; Index++)
+			// Keep the search handle alive while the results are converted
+			TSharedPtr<FSessionSearchEOS> SearchHandle = SearchHandleWrapper;
+
+			FSearchResultsStreamEOS Stream;
+			Stream.SearchSettings = SearchSettings;
+			Stream.NumResults = EOS_SessionSearch_GetSearchResultCount(SearchHandle->SearchHandle, &SearchResultOptions);
+			Stream.ConvertResult = [this, SearchHandle, SearchSettings](int32 Index)
 			{
-				EOS_HSessionDetails SessionHandle = nullptr;
+				EOS_SessionSearch_CopySearchResultByIndexOptions IndexOptions = { };
+				IndexOptions.ApiVersion = EOS_SESSIONSEARCH_COPYSEARCHRESULTBYINDEX_API_LATEST;
 				IndexOptions.SessionIndex = Index;
-				EOS_EResult Result = EOS_SessionSearch_CopySearchResultByIndex(CurrentSearchHandle->SearchHandle, &IndexOptions, &SessionHandle);
+				EOS_HSessionDetails SessionHandle = nullptr;
+				EOS_EResult Result = EOS_SessionSearch_CopySearchResultByIndex(SearchHandle->SearchHandle, &IndexOptions, &SessionHandle);
 				if (Result == EOS_EResult::EOS_Success)
 				{
 					AddSearchResult(SessionHandle, SearchSettings);
 				}
-			}
-			SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
+			};
+			Stream.OnFinished = [this, SearchSettings](bool bCompleted)
+			{
+				if (bCompleted)
+				{
+					SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
+				}
+				OnBackendSearchComplete(SearchSettings, bCompleted, !bCompleted);
+			};
+			StartSearchResultsStream(MoveTemp(Stream));
 		}
 		else
 		{
 			SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
 			UE_LOG_ONLINE_SESSION(Error, TEXT("EOS_SessionSearch_Find() failed with EOS result code (%s)"), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+			OnBackendSearchComplete(SearchSettings, false, false);
 		}
-		TriggerOnFindSessionsCompleteDelegates(bWasSuccessful);
 	};
 
 	SearchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
@@ -2711,6 +3291,8 @@ void FOnlineSessionEOS::Tick(float DeltaTime)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Session_Interface);
 	TickLanTasks(DeltaTime);
+	TickSessionUpdates();
+	TickSearchResultsStreams();
 }
 
 void FOnlineSessionEOS::TickLanTasks(float DeltaTime)
@@ -2761,37 +3343,62 @@ void FOnlineSessionEOS::AppendSessionSettingsToPacket(FNboSerializeToBufferEOS&
 		<< (uint8)SessionSettings->bAntiCheatProtected
 	    << SessionSettings->BuildUniqueId;
 
-	// First count number of advertised keys
-	int32 NumAdvertisedProperties = 0;
+	// The count goes first, so gather the advertised settings in the same pass that counts them
+	TArray<const FSessionSettings::ElementType*, TInlineAllocator<32>> AdvertisedSettings;
 	for (FSessionSettings::TConstIterator It(SessionSettings->Settings); It; ++It)
-	{	
-		const FOnlineSessionSetting& Setting = It.Value();
-		if (Setting.AdvertisementType >= EOnlineDataAdvertisementType::ViaOnlineService)
+	{
+		if (It.Value().AdvertisementType >= EOnlineDataAdvertisementType::ViaOnlineService)
 		{
-			NumAdvertisedProperties++;
+			AdvertisedSettings.Add(&*It);
 		}
 	}
 
 	// Add count of advertised keys and the data
-	Packet << (int32)NumAdvertisedProperties;
-	for (FSessionSettings::TConstIterator It(SessionSettings->Settings); It; ++It)
+	Packet << (int32)AdvertisedSettings.Num();
+	for (const FSessionSettings::ElementType* Setting : AdvertisedSettings)
 	{
-		const FOnlineSessionSetting& Setting = It.Value();
-		if (Setting.AdvertisementType >= EOnlineDataAdvertisementType::ViaOnlineService)
-		{
-			Packet << It.Key();
-			Packet << Setting;
+		Packet << Setting->Key;
+		Packet << Setting->Value;
 #if DEBUG_LAN_BEACON
-			UE_LOG_ONLINE_SESSION(Verbose, TEXT("%s"), *Setting.ToString());
+		UE_LOG_ONLINE_SESSION(Verbose, TEXT("%s"), *Setting->Value.ToString());
 #endif
-		}
 	}
 }
 
+FLanResponsePacketEOS& FOnlineSessionEOS::GetLanResponsePacket(FNamedOnlineSession* Session)
+{
+	// Try to get the actual port the netdriver is using, which can change once it starts listening
+	SetPortFromNetDriver(*EOSSubsystem, Session->SessionInfo);
+	TSharedPtr<FOnlineSessionInfoEOS> SessionInfoEOS = StaticCastSharedPtr<FOnlineSessionInfoEOS>(Session->SessionInfo);
+	const int32 HostPort = SessionInfoEOS.IsValid() && SessionInfoEOS->HostAddr.IsValid() ? SessionInfoEOS->HostAddr->GetPort() : 0;
+
+	FLanResponsePacketEOS& Response = LanResponsePackets.FindOrAdd(Session->SessionName);
+	if (Response.Packet.Num() == 0 ||
+		Response.NumOpenPrivateConnections != Session->NumOpenPrivateConnections ||
+		Response.NumOpenPublicConnections != Session->NumOpenPublicConnections ||
+		Response.HostPort != HostPort)
+	{
+		FNboSerializeToBufferEOS Packet(LAN_BEACON_MAX_PACKET_SIZE);
+		// The header ends with the client nonce, which each reply overwrites in its own copy
+		LANSession->CreateHostResponsePacket(Packet, 0);
+		Response.NonceOffset = int32(Packet.GetByteCount()) - int32(sizeof(uint64));
+
+		// Add all the session details
+		AppendSessionToPacket(Packet, Session);
+
+		Response.Packet = TArray<uint8>(static_cast<uint8*>(Packet), Packet.GetByteCount());
+		Response.NumOpenPrivateConnections = Session->NumOpenPrivateConnections;
+		Response.NumOpenPublicConnections = Session->NumOpenPublicConnections;
+		Response.HostPort = HostPort;
+	}
+	return Response;
+}
+
 void FOnlineSessionEOS::OnValidQueryPacketReceived(uint8* PacketData, int32 PacketLength, uint64 ClientNonce)
 {
-	// Iterate through all registered sessions and respond for each LAN match
-	FScopeLock ScopeLock(&SessionLock);
+	// Iterate through all registered sessions and respond for each LAN match.
+	// Write lock, as building a response fills the packet cache and may update the session's host port
+	FRWScopeLock ScopeLock(SessionLock, SLT_Write);
 	for (int32 SessionIndex = 0; SessionIndex < Sessions.Num(); SessionIndex++)
 	{
 		FNamedOnlineSession* Session = &Sessions[SessionIndex];
@@ -2809,15 +3416,18 @@ void FOnlineSessionEOS::OnValidQueryPacketReceived(uint8* PacketData, int32 Pack
 
 			if (bIsMatchJoinable)
 			{
-				FNboSerializeToBufferEOS Packet(LAN_BEACON_MAX_PACKET_SIZE);
-				// Create the basic header before appending additional information
-				LANSession->CreateHostResponsePacket(Packet, ClientNonce);
+				const FLanResponsePacketEOS& Response = GetLanResponsePacket(Session);
 
-				// Add all the session details
-				AppendSessionToPacket(Packet, Session);
+				// Only the nonce differs between replies. Patched into a copy, so the cached packet is never written outside of a rebuild.
+				// Written in network byte order, as FNboSerializeToBuffer does
+				TArray<uint8, TInlineAllocator<LAN_BEACON_MAX_PACKET_SIZE>> Packet(Response.Packet);
+				for (int32 ByteIndex = 0; ByteIndex < int32(sizeof(uint64)); ByteIndex++)
+				{
+					Packet[Response.NonceOffset + ByteIndex] = uint8(ClientNonce >> (8 * (sizeof(uint64) - 1 - ByteIndex)));
+				}
 
 				// Broadcast this response so the client can see us
-				LANSession->BroadcastPacket(Packet, Packet.GetByteCount());
+				LANSession->BroadcastPacket(Packet.GetData(), Packet.Num());
 			}
 		}
 	}
@@ -2949,7 +3559,7 @@ void FOnlineSessionEOS::OnLANSearchTimeout()
 	bool bWasHosting = false;
 
 	{
-		FScopeLock ScopeLock(&SessionLock);
+		FRWScopeLock ScopeLock(SessionLock, SLT_ReadOnly);
 		for (int32 SessionIdx = 0; SessionIdx < Sessions.Num(); SessionIdx++)
 		{
 			FNamedOnlineSession& Session = Sessions[SessionIdx];
@@ -3000,13 +3610,13 @@ void FOnlineSessionEOS::OnLANSearchTimeout()
 
 int32 FOnlineSessionEOS::GetNumSessions()
 {
-	FScopeLock ScopeLock(&SessionLock);
+	FRWScopeLock ScopeLock(SessionLock, SLT_ReadOnly);
 	return Sessions.Num();
 }
 
 void FOnlineSessionEOS::DumpSessionState()
 {
-	FScopeLock ScopeLock(&SessionLock);
+	FRWScopeLock ScopeLock(SessionLock, SLT_ReadOnly);
 
 	for (int32 SessionIdx=0; SessionIdx < Sessions.Num(); SessionIdx++)
 	{
@@ -3159,6 +3769,7 @@ uint32 FOnlineSessionEOS::CreateLobbySession(int32 HostingPlayerNum, FNamedOnlin
 				FString HostAddr = TempAddr.ToString(true);
 
 				Session->SessionInfo = MakeShareable(new FOnlineSessionInfoEOS(HostAddr, Data->LobbyId, nullptr));
+				IndexLobbySession(Session);
 
 #if WITH_EOS_RTC
 				if (FEOSVoiceChatUser* VoiceChatUser = static_cast<FEOSVoiceChatUser*>(EOSSubsystem->GetEOSVoiceChatUserInterface(*LocalUserNetId)))
@@ -3169,7 +3780,9 @@ uint32 FOnlineSessionEOS::CreateLobbySession(int32 HostingPlayerNum, FNamedOnlin
 
 				BeginSessionAnalytics(Session);
 
-				UpdateLobbySession(Session);
+				// A new lobby has nothing published yet, so everything goes out. This also sends any updates queued while it was being created
+				PublishedAttributeSets.Remove(SessionName);
+				DispatchSessionUpdate(SessionName, SessionUpdateStates.FindOrAdd(SessionName));
 			}
 			else
 			{
@@ -3206,6 +3819,7 @@ uint32 FOnlineSessionEOS::JoinLobbySession(int32 PlayerNum, FNamedOnlineSession*
 			EOSSessionInfo->SessionHandle = SearchSessionInfo->SessionHandle;
 			EOSSessionInfo->SessionId = SearchSessionInfo->SessionId;
 			EOSSessionInfo->bIsFromClone = SearchSessionInfo->bIsFromClone;
+			IndexLobbySession(Session);
 
 			Session->SessionState = EOnlineSessionState::Pending;
 			
@@ -3255,6 +3869,7 @@ uint32 FOnlineSessionEOS::JoinLobbySession(int32 PlayerNum, FNamedOnlineSession*
 					}
 
 					LobbySearchResultsCache.Reset();
+					RemoveCachedLobbySearches();
 				}
 			};
 
@@ -3315,6 +3930,19 @@ void FOnlineSessionEOS::AddLobbyAttribute(EOS_HLobbyModification LobbyModificati
 	}
 }
 
+void FOnlineSessionEOS::RemoveLobbyAttribute(EOS_HLobbyModification LobbyModificationHandle, FName Key)
+{
+	EOS_LobbyModification_RemoveAttributeOptions Options = { };
+	Options.ApiVersion = EOS_LOBBYMODIFICATION_REMOVEATTRIBUTE_API_LATEST;
+	Options.Key = GetAttributeKey(Key);
+
+	EOS_EResult ResultCode = EOS_LobbyModification_RemoveAttribute(LobbyModificationHandle, &Options);
+	if (ResultCode != EOS_EResult::EOS_Success)
+	{
+		UE_LOG_ONLINE_SESSION(Error, TEXT("[FOnlineSessionEOS::RemoveLobbyAttribute] LobbyModification_RemoveAttribute for attribute name (%s) not successful. Finished with EOS_EResult %s"), *Key.ToString(), ANSI_TO_TCHAR(EOS_EResult_ToString(ResultCode)));
+	}
+}
+
 void FOnlineSessionEOS::AddLobbyMemberAttribute(EOS_HLobbyModification LobbyModificationHandle, const EOS_Lobby_AttributeData* Attribute)
 {
 	EOS_LobbyModification_AddMemberAttributeOptions Options = { };
@@ -3329,58 +3957,65 @@ void FOnlineSessionEOS::AddLobbyMemberAttribute(EOS_HLobbyModification LobbyModi
 	}
 }
 
-void FOnlineSessionEOS::SetLobbyAttributes(EOS_HLobbyModification LobbyModificationHandle, FNamedOnlineSession* Session)
+void FOnlineSessionEOS::RemoveLobbyMemberAttribute(EOS_HLobbyModification LobbyModificationHandle, FName Key)
+{
+	EOS_LobbyModification_RemoveMemberAttributeOptions Options = { };
+	Options.ApiVersion = EOS_LOBBYMODIFICATION_REMOVEMEMBERATTRIBUTE_API_LATEST;
+	Options.Key = GetAttributeKey(Key);
+
+	EOS_EResult ResultCode = EOS_LobbyModification_RemoveMemberAttribute(LobbyModificationHandle, &Options);
+	if (ResultCode != EOS_EResult::EOS_Success)
+	{
+		UE_LOG_ONLINE_SESSION(Error, TEXT("[FOnlineSessionEOS::RemoveLobbyMemberAttribute] LobbyModification_RemoveMemberAttribute for attribute name (%s) not successful. Finished with EOS_EResult %s"), *Key.ToString(), ANSI_TO_TCHAR(EOS_EResult_ToString(ResultCode)));
+	}
+}
+
+void FOnlineSessionEOS::BuildLobbyAttributeSet(FNamedOnlineSession* Session, FSessionAttributeSetEOS& OutAttributeSet)
 {
 	check(Session != nullptr);
 
+	static const FName SearchPresenceName(*(TEXT("FOSS=") + SEARCH_PRESENCE.ToString()));
+	static const FName SearchLobbiesName(*(TEXT("FOSS=") + SEARCH_LOBBIES.ToString()));
+	static const FName SearchKeywordsName(*(TEXT("FOSS=") + SEARCH_KEYWORDS.ToString()));
+	static const FName OwningUserIdName(TEXT("OwningUserId"));
+	static const FName OwningUserNameName(TEXT("OwningUserName"));
+	static const FName NumPrivateConnectionsName(TEXT("NumPrivateConnections"));
+	static const FName NumPublicConnectionsName(TEXT("NumPublicConnections"));
+	static const FName AntiCheatProtectedName(TEXT("bAntiCheatProtected"));
+	static const FName UsesStatsName(TEXT("bUsesStats"));
+	static const FName IsDedicatedName(TEXT("bIsDedicated"));
+	static const FName BuildUniqueIdName(TEXT("BuildUniqueId"));
+
+	OutAttributeSet.Properties.Add(PermissionLevelProperty, FVariantData((int32)GetLobbyPermissionLevelFromSessionSettings(Session->SessionSettings)));
+	OutAttributeSet.Properties.Add(MaxMembersProperty, FVariantData(GetLobbyMaxMembersFromSessionSettings(Session->SessionSettings)));
+
 	// The first will let us find it on session searches
-	const FString SearchPresence(TEXT("FOSS=") + SEARCH_PRESENCE.ToString());
-	const FLobbyAttributeOptions SearchPresenceAttribute(TCHAR_TO_UTF8(*SearchPresence), true);
-	AddLobbyAttribute(LobbyModificationHandle, &SearchPresenceAttribute);
+	OutAttributeSet.Attributes.Add(SearchPresenceName, FVariantData(true));
 
 	// The second will let us find it on lobby searches
-	const FString SearchLobbies(TEXT("FOSS=") + SEARCH_LOBBIES.ToString());
-	const FLobbyAttributeOptions SearchLobbiesAttribute(TCHAR_TO_UTF8(*SearchLobbies), true);
-	AddLobbyAttribute(LobbyModificationHandle, &SearchLobbiesAttribute);
+	OutAttributeSet.Attributes.Add(SearchLobbiesName, FVariantData(true));
 
-	// The second will let us find it on lobby searches
+	// The third will let us find it on keyword searches
 	FString Keyword;
 	Session->SessionSettings.Get(SEARCH_KEYWORDS, Keyword);
-	const FString SearchKeywords(TEXT("FOSS=") + SEARCH_KEYWORDS.ToString());
-	const FLobbyAttributeOptions SearchKeywordsAttribute(TCHAR_TO_UTF8(*SearchKeywords), TCHAR_TO_UTF8(*Keyword));
-	AddLobbyAttribute(LobbyModificationHandle, &SearchKeywordsAttribute);
+	OutAttributeSet.Attributes.Add(SearchKeywordsName, FVariantData(Keyword));
 
 	// We set the session's owner id and name
-	const FLobbyAttributeOptions OwnerId("OwningUserId", TCHAR_TO_UTF8(*Session->OwningUserId->ToString()));
-	AddLobbyAttribute(LobbyModificationHandle, &OwnerId);
-
-	const FLobbyAttributeOptions OwnerName("OwningUserName", TCHAR_TO_UTF8(*Session->OwningUserName));
-	AddLobbyAttribute(LobbyModificationHandle, &OwnerName);
+	OutAttributeSet.Attributes.Add(OwningUserIdName, FVariantData(Session->OwningUserId->ToString()));
+	OutAttributeSet.Attributes.Add(OwningUserNameName, FVariantData(Session->OwningUserName));
 
 	// Now the session settings
-	const FLobbyAttributeOptions Opt1("NumPrivateConnections", Session->SessionSettings.NumPrivateConnections);
-	AddLobbyAttribute(LobbyModificationHandle, &Opt1);
-
-	const FLobbyAttributeOptions Opt2("NumPublicConnections", Session->SessionSettings.NumPublicConnections);
-	AddLobbyAttribute(LobbyModificationHandle, &Opt2);
-
-	const FLobbyAttributeOptions Opt5("bAntiCheatProtected", Session->SessionSettings.bAntiCheatProtected);
-	AddLobbyAttribute(LobbyModificationHandle, &Opt5);
-
-	const FLobbyAttributeOptions Opt6("bUsesStats", Session->SessionSettings.bUsesStats);
-	AddLobbyAttribute(LobbyModificationHandle, &Opt6);
-
+	OutAttributeSet.Attributes.Add(NumPrivateConnectionsName, FVariantData(Session->SessionSettings.NumPrivateConnections));
+	OutAttributeSet.Attributes.Add(NumPublicConnectionsName, FVariantData(Session->SessionSettings.NumPublicConnections));
+	OutAttributeSet.Attributes.Add(AntiCheatProtectedName, FVariantData(Session->SessionSettings.bAntiCheatProtected));
+	OutAttributeSet.Attributes.Add(UsesStatsName, FVariantData(Session->SessionSettings.bUsesStats));
 	// Likely unnecessary for lobbies
-	const FLobbyAttributeOptions Opt7("bIsDedicated", Session->SessionSettings.bIsDedicated);
-	AddLobbyAttribute(LobbyModificationHandle, &Opt7);
-
-	const FLobbyAttributeOptions Opt8("BuildUniqueId", Session->SessionSettings.BuildUniqueId);
-	AddLobbyAttribute(LobbyModificationHandle, &Opt8);
+	OutAttributeSet.Attributes.Add(IsDedicatedName, FVariantData(Session->SessionSettings.bIsDedicated));
+	OutAttributeSet.Attributes.Add(BuildUniqueIdName, FVariantData(Session->SessionSettings.BuildUniqueId));
 
 	// Add all of the custom settings
 	for (FSessionSettings::TConstIterator It(Session->SessionSettings.Settings); It; ++It)
 	{
-		const FName KeyName = It.Key();
 		const FOnlineSessionSetting& Setting = It.Value();
 
 		// Skip unsupported types or non session advertised settings
@@ -3389,8 +4024,7 @@ void FOnlineSessionEOS::SetLobbyAttributes(EOS_HLobbyModification LobbyModificat
 			continue;
 		}
 
-		const FLobbyAttributeOptions Attribute(TCHAR_TO_UTF8(*KeyName.ToString()), Setting.Data);
-		AddLobbyAttribute(LobbyModificationHandle, &Attribute);
+		OutAttributeSet.Attributes.Add(It.Key(), Setting.Data);
 	}
 
 	// Add all of the member settings
@@ -3401,7 +4035,6 @@ void FOnlineSessionEOS::SetLobbyAttributes(EOS_HLobbyModification LobbyModificat
 		{
 			for (FSessionSettings::TConstIterator It(MemberSettings.Value); It; ++It)
 			{
-				const FName KeyName = It.Key();
 				const FOnlineSessionSetting& Setting = It.Value();
 
 				// Skip unsupported types or non session advertised settings
@@ -3410,13 +4043,49 @@ void FOnlineSessionEOS::SetLobbyAttributes(EOS_HLobbyModification LobbyModificat
 					continue;
 				}
 
-				const FLobbyAttributeOptions Attribute(TCHAR_TO_UTF8(*KeyName.ToString()), Setting.Data);
-				AddLobbyMemberAttribute(LobbyModificationHandle, &Attribute);
+				OutAttributeSet.MemberAttributes.Add(It.Key(), Setting.Data);
 			}
 		}
 	}
 }
 
+void FOnlineSessionEOS::SetLobbyAttributes(EOS_HLobbyModification LobbyModificationHandle, const FSessionAttributeSetEOS& AttributeSet, const FSessionAttributeSetEOS& PublishedSet)
+{
+	for (const TPair<FName, FVariantData>& Pair : AttributeSet.Attributes)
+	{
+		if (HasAttributeChanged(PublishedSet.Attributes, Pair.Key, Pair.Value))
+		{
+			const FLobbyAttributeOptions Attribute(GetAttributeKey(Pair.Key), Pair.Value);
+			AddLobbyAttribute(LobbyModificationHandle, &Attribute);
+		}
+	}
+
+	for (const TPair<FName, FVariantData>& Pair : PublishedSet.Attributes)
+	{
+		if (!AttributeSet.Attributes.Contains(Pair.Key))
+		{
+			RemoveLobbyAttribute(LobbyModificationHandle, Pair.Key);
+		}
+	}
+
+	for (const TPair<FName, FVariantData>& Pair : AttributeSet.MemberAttributes)
+	{
+		if (HasAttributeChanged(PublishedSet.MemberAttributes, Pair.Key, Pair.Value))
+		{
+			const FLobbyAttributeOptions Attribute(GetAttributeKey(Pair.Key), Pair.Value);
+			AddLobbyMemberAttribute(LobbyModificationHandle, &Attribute);
+		}
+	}
+
+	for (const TPair<FName, FVariantData>& Pair : PublishedSet.MemberAttributes)
+	{
+		if (!AttributeSet.MemberAttributes.Contains(Pair.Key))
+		{
+			RemoveLobbyMemberAttribute(LobbyModificationHandle, Pair.Key);
+		}
+	}
+}
+
 uint32 FOnlineSessionEOS::UpdateLobbySession(FNamedOnlineSession* Session)
 {
 	check(Session != nullptr);
@@ -3425,7 +4094,18 @@ uint32 FOnlineSessionEOS::UpdateLobbySession(FNamedOnlineSession* Session)
 
 	if (Session->SessionState == EOnlineSessionState::Creating)
 	{
-		Result = ONLINE_IO_PENDING;
+		return ONLINE_IO_PENDING;
+	}
+
+	FSessionAttributeSetEOS AttributeSet;
+	BuildLobbyAttributeSet(Session, AttributeSet);
+
+	// Don't spend an update on a lobby the backend already has the latest of
+	const FSessionAttributeSetEOS* PublishedSet = PublishedAttributeSets.Find(Session->SessionName);
+	if (PublishedSet != nullptr && *PublishedSet == AttributeSet)
+	{
+		UE_LOG_ONLINE_SESSION(Verbose, TEXT("[FOnlineSessionEOS::UpdateLobbySession] Skipping update of lobby session (%s) as nothing changed since it was last published"), *Session->SessionName.ToString());
+		Result = ONLINE_SUCCESS;
 	}
 	else
 	{
@@ -3440,9 +4120,18 @@ uint32 FOnlineSessionEOS::UpdateLobbySession(FNamedOnlineSession* Session)
 		EOS_EResult LobbyModificationResult = EOS_Lobby_UpdateLobbyModification(LobbyHandle, &UpdateLobbyModificationOptions, &LobbyModificationHandle);
 		if (LobbyModificationResult == EOS_EResult::EOS_Success)
 		{
-			SetLobbyPermissionLevel(LobbyModificationHandle, Session);
-			SetLobbyMaxMembers(LobbyModificationHandle, Session);
-			SetLobbyAttributes(LobbyModificationHandle, Session);
+			// Only send what changed since the last update. Assume it lands; a failed update forgets the published set
+			FSessionAttributeSetEOS& UpdatedSet = PublishedAttributeSets.FindOrAdd(Session->SessionName);
+			if (HasPropertyChanged(AttributeSet, UpdatedSet, PermissionLevelProperty))
+			{
+				SetLobbyPermissionLevel(LobbyModificationHandle, Session);
+			}
+			if (HasPropertyChanged(AttributeSet, UpdatedSet, MaxMembersProperty))
+			{
+				SetLobbyMaxMembers(LobbyModificationHandle, Session);
+			}
+			SetLobbyAttributes(LobbyModificationHandle, AttributeSet, UpdatedSet);
+			UpdatedSet = MoveTemp(AttributeSet);
 
 			EOS_Lobby_UpdateLobbyOptions UpdateLobbyOptions = { 0 };
 			UpdateLobbyOptions.ApiVersion = EOS_LOBBY_UPDATELOBBY_API_LATEST;
@@ -3459,10 +4148,17 @@ uint32 FOnlineSessionEOS::UpdateLobbySession(FNamedOnlineSession* Session)
 					if (!bWasSuccessful)
 					{
 						Session->SessionState = EOnlineSessionState::NoSession;
+						PublishedAttributeSets.Remove(SessionName);
 						UE_LOG_ONLINE_SESSION(Warning, TEXT("[FOnlineSessionEOS::UpdateLobbySession] UpdateLobby not successful. Finished with EOS_EResult %s"), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
 					}
 
-					TriggerOnUpdateSessionCompleteDelegates(Session->SessionName, bWasSuccessful);
+					OnSessionUpdateComplete(SessionName, bWasSuccessful);
+				}
+				else if (FSessionUpdateStateEOS* UpdateState = SessionUpdateStates.Find(SessionName))
+				{
+					// Nobody to notify, but let queued updates find out the session is gone
+					UpdateState->NumInFlightCallers = 0;
+					UpdateState->bInFlight = false;
 				}
 			};
 
@@ -3635,14 +4331,13 @@ uint32 FOnlineSessionEOS::FindLobbySession(int32 SearchingPlayerNum, const TShar
 
 			UE_LOG_ONLINE_SESSION(VeryVerbose, TEXT("[FOnlineSessionEOS::FindLobbySession] Adding lobby search param named (%s), (%s)"), *Key.ToString(), *SearchParam.ToString());
 
-			FString ParamName(TEXT("FOSS=") + Key.ToString());
-			FLobbyAttributeOptions Attribute(TCHAR_TO_UTF8(*ParamName), SearchParam.Data);
+			FLobbyAttributeOptions Attribute(GetSearchAttributeKey(Key), SearchParam.Data);
 			AddLobbySearchAttribute(LobbySearchHandle, &Attribute, ToEOSSearchOp(SearchParam.ComparisonOp));
 		}
 
-		StartLobbySearch(SearchingPlayerNum, LobbySearchHandle, SearchSettings, FOnSingleSessionResultCompleteDelegate::CreateLambda([this](int32 LocalUserNum, bool bWasSuccessful, const FOnlineSessionSearchResult& EOSResult)
+		StartLobbySearch(SearchingPlayerNum, LobbySearchHandle, SearchSettings, FOnSingleSessionResultCompleteDelegate::CreateLambda([this, SearchSettings](int32 LocalUserNum, bool bWasSuccessful, const FOnlineSessionSearchResult& EOSResult)
 		{
-			TriggerOnFindSessionsCompleteDelegates(bWasSuccessful);
+			OnBackendSearchComplete(SearchSettings, bWasSuccessful, false);
 		}));
 
 		Result = ONLINE_IO_PENDING;
@@ -3671,8 +4366,6 @@ void FOnlineSessionEOS::StartLobbySearch(int32 SearchingPlayerNum, EOS_HLobbySea
 		{
 			UE_LOG_ONLINE_SESSION(Log, TEXT("[FOnlineSessionEOS::StartLobbySearch] LobbySearch_Find was successful."));
 
-			LobbySearchResultsCache.Reset();
-
 			EOS_LobbySearch_GetSearchResultCountOptions GetSearchResultCountOptions = { 0 };
 			GetSearchResultCountOptions.ApiVersion = EOS_LOBBYSEARCH_GETSEARCHRESULTCOUNT_API_LATEST;
 
@@ -3680,15 +4373,16 @@ void FOnlineSessionEOS::StartLobbySearch(int32 SearchingPlayerNum, EOS_HLobbySea
 
 			if (SearchResultsCount > 0)
 			{
-				EOS_LobbySearch_CopySearchResultByIndexOptions CopySearchResultByIndexOptions = { 0 };
-				CopySearchResultByIndexOptions.ApiVersion = EOS_LOBBYSEARCH_COPYSEARCHRESULTBYINDEX_API_LATEST;
-
-				for (uint32_t LobbyIndex = 0; LobbyIndex < SearchResultsCount; LobbyIndex++)
+				FSearchResultsStreamEOS Stream;
+				Stream.SearchSettings = SearchSettings;
+				Stream.NumResults = SearchResultsCount;
+				Stream.ConvertResult = [this, LobbySearchHandle, SearchSettings](int32 LobbyIndex)
 				{
-					EOS_HLobbyDetails LobbyDetailsHandle;
-
+					EOS_LobbySearch_CopySearchResultByIndexOptions CopySearchResultByIndexOptions = { 0 };
+					CopySearchResultByIndexOptions.ApiVersion = EOS_LOBBYSEARCH_COPYSEARCHRESULTBYINDEX_API_LATEST;
 					CopySearchResultByIndexOptions.LobbyIndex = LobbyIndex;
 
+					EOS_HLobbyDetails LobbyDetailsHandle;
 					EOS_EResult Result = EOS_LobbySearch_CopySearchResultByIndex(LobbySearchHandle, &CopySearchResultByIndexOptions, &LobbyDetailsHandle);
 					if (Result == EOS_EResult::EOS_Success)
 					{
@@ -3698,19 +4392,35 @@ void FOnlineSessionEOS::StartLobbySearch(int32 SearchingPlayerNum, EOS_HLobbySea
 					}
 					else
 					{
-						UE_LOG_ONLINE_SESSION(Warning, TEXT("[FOnlineSessionEOS::StartLobbySearch::FLobbySearchFindCallback] LobbySearch_CopySearchResultByIndex not successful. Finished with EOS_EResult %s"), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+						UE_LOG_ONLINE_SESSION(Warning, TEXT("[FOnlineSessionEOS::StartLobbySearch::FLobbySearchFindCallback] LobbySearch_CopySearchResultByIndex not successful. Finished with EOS_EResult %s"), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
 					}
-				}
+				};
+				Stream.OnFinished = [this, SearchingPlayerNum, LobbySearchHandle, SearchSettings, CompletionDelegate](bool bCompleted)
+				{
+					if (bCompleted)
+					{
+						SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
 
-				CurrentSessionSearch->SearchState = EOnlineAsyncTaskState::Done;
+						CompletionDelegate.ExecuteIfBound(SearchingPlayerNum, true, SearchSettings->SearchResults.Num() > 0 ? SearchSettings->SearchResults.Last() : FOnlineSessionSearchResult());
+					}
+					else
+					{
+						// Lets anything waiting on this search through the cache go
+						OnBackendSearchComplete(SearchSettings, false, true);
+					}
 
-				CompletionDelegate.ExecuteIfBound(SearchingPlayerNum, true, SearchSettings->SearchResults.Last());
+					EOS_LobbySearch_Release(LobbySearchHandle);
+				};
+
+				// The stream releases the search handle once it is done with it
+				StartSearchResultsStream(MoveTemp(Stream));
+				return;
 			}
 			else
 			{
 				UE_LOG_ONLINE_SESSION(Log, TEXT("[FOnlineSessionEOS::StartLobbySearch::FLobbySearchFindCallback] LobbySearch_GetSearchResultCount returned no results"));
 
-				CurrentSessionSearch->SearchState = EOnlineAsyncTaskState::Failed;
+				SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
 
 				CompletionDelegate.ExecuteIfBound(SearchingPlayerNum, false, FOnlineSessionSearchResult());
 			}
@@ -3719,7 +4429,7 @@ void FOnlineSessionEOS::StartLobbySearch(int32 SearchingPlayerNum, EOS_HLobbySea
 		{
 			UE_LOG_ONLINE_SESSION(Warning, TEXT("[FOnlineSessionEOS::StartLobbySearch::FLobbySearchFindCallback] LobbySearch_Find not successful. Finished with EOS_EResult %s"), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
 
-			CurrentSessionSearch->SearchState = EOnlineAsyncTaskState::Failed;
+			SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
 
 			CompletionDelegate.ExecuteIfBound(SearchingPlayerNum, false, FOnlineSessionSearchResult());
 		}
@@ -3748,7 +4458,8 @@ void FOnlineSessionEOS::AddLobbySearchResult(EOS_HLobbyDetails LobbyDetailsHandl
 		FInternetAddrEOS TempAddr(LexToString(LobbyDetailsInfo->LobbyOwnerUserId), NetDriverName.ToString(), GetTypeHash(NetDriverName.ToString()));
 		FString HostAddr = TempAddr.ToString(true);
 
-		SearchResult.Session.SessionInfo = MakeShareable(new FOnlineSessionInfoEOS(HostAddr, LobbyDetailsInfo->LobbyId, nullptr));
+		SearchResult.Session.SessionInfo = MakeShared<FOnlineSessionInfoEOS>(HostAddr, LobbyDetailsInfo->LobbyId, nullptr);
+		const FString LobbyId(LobbyDetailsInfo->LobbyId);
 
 		// We copy the lobby data and settings
 		CopyLobbyData(LobbyDetailsHandle, LobbyDetailsInfo, SearchResult.Session);
@@ -3757,6 +4468,7 @@ void FOnlineSessionEOS::AddLobbySearchResult(EOS_HLobbyDetails LobbyDetailsHandl
 		EOS_LobbyDetails_GetMemberCountOptions CountOptions = { };
 		CountOptions.ApiVersion = EOS_LOBBYDETAILS_GETMEMBERCOUNT_API_LATEST;
 		int32 Count = EOS_LobbyDetails_GetMemberCount(LobbyDetailsHandle, &CountOptions);
+		SearchResult.Session.SessionSettings.MemberSettings.Reserve(Count);
 
 		for (int32 Index = 0; Index < Count; Index++)
 		{
@@ -3766,8 +4478,20 @@ void FOnlineSessionEOS::AddLobbySearchResult(EOS_HLobbyDetails LobbyDetailsHandl
 
 			EOS_ProductUserId TargetUserId = EOS_LobbyDetails_GetMemberByIndex(LobbyDetailsHandle, &GetMemberByIndexOptions);
 
-			EOSSubsystem->UserManager->GetEpicAccountIdAsync(TargetUserId, [this, LobbyDetailsHandle, &SearchResult](const EOS_ProductUserId& ProductUserId, EOS_EpicAccountId& EpicAccountId)
+			// Resolved ids can come back after more results were added, so look the result up again rather than keeping a reference into the array.
+			// The search may also have been rerun since, so make sure the slot still holds this lobby
+			EOSSubsystem->UserManager->GetEpicAccountIdAsync(TargetUserId, [this, LobbyDetailsHandle, SearchSettings, Position, LobbyId](const EOS_ProductUserId& ProductUserId, EOS_EpicAccountId& EpicAccountId)
 				{
+					if (!SearchSettings->SearchResults.IsValidIndex(Position))
+					{
+						return;
+					}
+					FOnlineSessionSearchResult& SearchResult = SearchSettings->SearchResults[Position];
+					if (!SearchResult.Session.SessionInfo.IsValid() || SearchResult.Session.SessionInfo->GetSessionId().ToString() != LobbyId)
+					{
+						return;
+					}
+
 					TSharedPtr<const FUniqueNetId> UniqueNetId = EOSSubsystem->UserManager->CreateUniquePlayerId(MakeNetIdStringFromIds(EpicAccountId, ProductUserId));
 
 					if (!SearchResult.Session.SessionSettings.MemberSettings.Contains(UniqueNetId->AsShared()))
@@ -3779,7 +4503,12 @@ void FOnlineSessionEOS::AddLobbySearchResult(EOS_HLobbyDetails LobbyDetailsHandl
 				});
 		}
 
-		LobbySearchResultsCache.Add(FString(LobbyDetailsInfo->LobbyId), MakeShared<EOS_HLobbyDetails>(LobbyDetailsHandle));
+		// Searches no longer reset the handles, since cached results may still need them, so replace any we already had for this lobby
+		if (TSharedRef<EOS_HLobbyDetails>* ExistingHandle = LobbySearchResultsCache.Find(LobbyId))
+		{
+			EOS_LobbyDetails_Release(**ExistingHandle);
+		}
+		LobbySearchResultsCache.Add(LobbyId, MakeShared<EOS_HLobbyDetails>(LobbyDetailsHandle));
 
 		EOS_LobbyDetails_Info_Release(LobbyDetailsInfo);
 
@@ -3834,6 +4563,7 @@ void FOnlineSessionEOS::CopyLobbyAttributes(EOS_HLobbyDetails LobbyDetailsHandle
 	EOS_LobbyDetails_GetAttributeCountOptions CountOptions = { };
 	CountOptions.ApiVersion = EOS_LOBBYDETAILS_GETATTRIBUTECOUNT_API_LATEST;
 	int32 Count = EOS_LobbyDetails_GetAttributeCount(LobbyDetailsHandle, &CountOptions);
+	OutSession.SessionSettings.Settings.Reserve(Count);
 
 	for (int32 Index = 0; Index < Count; Index++)
 	{
@@ -3845,41 +4575,51 @@ void FOnlineSessionEOS::CopyLobbyAttributes(EOS_HLobbyDetails LobbyDetailsHandle
 		EOS_EResult ResultCode = EOS_LobbyDetails_CopyAttributeByIndex(LobbyDetailsHandle, &AttrOptions, &Attribute);
 		if (ResultCode == EOS_EResult::EOS_Success)
 		{
-			FString Key = UTF8_TO_TCHAR(Attribute->Data->Key);
-			if (Key == TEXT("OwningUserId"))
+			const FName Key(UTF8_TO_TCHAR(Attribute->Data->Key));
+			switch (GetBuiltInAttribute(Key))
+			{
+			case EBuiltInAttributeEOS::OwningUserId:
 			{
 				OutSession.OwningUserId = FUniqueNetIdEOS::Create(UTF8_TO_TCHAR(Attribute->Data->Value.AsUtf8));
+				break;
 			}
-			else if (Key == TEXT("OwningUserName"))
+			case EBuiltInAttributeEOS::OwningUserName:
 			{
 				OutSession.OwningUserName = UTF8_TO_TCHAR(Attribute->Data->Value.AsUtf8);
+				break;
 			}
-			else if (Key == TEXT("NumPublicConnections"))
+			case EBuiltInAttributeEOS::NumPublicConnections:
 			{
 				OutSession.SessionSettings.NumPublicConnections = Attribute->Data->Value.AsInt64;
+				break;
 			}
-			else if (Key == TEXT("NumPrivateConnections"))
+			case EBuiltInAttributeEOS::NumPrivateConnections:
 			{
 				OutSession.SessionSettings.NumPrivateConnections = Attribute->Data->Value.AsInt64;
+				break;
 			}
-			else if (Key == TEXT("bAntiCheatProtected"))
+			case EBuiltInAttributeEOS::AntiCheatProtected:
 			{
 				OutSession.SessionSettings.bAntiCheatProtected = Attribute->Data->Value.AsBool == EOS_TRUE;
+				break;
 			}
-			else if (Key == TEXT("bUsesStats"))
+			case EBuiltInAttributeEOS::UsesStats:
 			{
 				OutSession.SessionSettings.bUsesStats = Attribute->Data->Value.AsBool == EOS_TRUE;
+				break;
 			}
-			else if (Key == TEXT("bIsDedicated"))
+			case EBuiltInAttributeEOS::IsDedicated:
 			{
 				OutSession.SessionSettings.bIsDedicated = Attribute->Data->Value.AsBool == EOS_TRUE;
+				break;
 			}
-			else if (Key == TEXT("BuildUniqueId"))
+			case EBuiltInAttributeEOS::BuildUniqueId:
 			{
 				OutSession.SessionSettings.BuildUniqueId = Attribute->Data->Value.AsInt64;
+				break;
 			}
 			// Handle FSessionSettings
-			else
+			default:
 			{
 				FOnlineSessionSetting Setting;
 				switch (Attribute->Data->ValueType)
@@ -3906,7 +4646,9 @@ void FOnlineSessionEOS::CopyLobbyAttributes(EOS_HLobbyDetails LobbyDetailsHandle
 				}
 				}
 
-				OutSession.SessionSettings.Settings.FindOrAdd(FName(Key), Setting);
+				OutSession.SessionSettings.Settings.FindOrAdd(Key, Setting);
+				break;
+			}
 			}
 		}
 
@@ -3933,7 +4675,7 @@ void FOnlineSessionEOS::CopyLobbyMemberAttributes(EOS_HLobbyDetails LobbyDetails
 		EOS_EResult ResultCode = EOS_LobbyDetails_CopyMemberAttributeByIndex(LobbyDetailsHandle, &AttrOptions, &Attribute);
 		if (ResultCode == EOS_EResult::EOS_Success)
 		{
-			FString Key = Attribute->Data->Key;
+			const FName Key(UTF8_TO_TCHAR(Attribute->Data->Key));
 
 			FOnlineSessionSetting Setting;
 			switch (Attribute->Data->ValueType)
@@ -3960,14 +4702,7 @@ void FOnlineSessionEOS::CopyLobbyMemberAttributes(EOS_HLobbyDetails LobbyDetails
 			}
 			}
 
-			if (OutSessionSettings.Contains(FName(Key)))
-			{
-				OutSessionSettings[FName(Key)] = Setting;
-			}
-			else
-			{
-				OutSessionSettings.Add(FName(Key), Setting);
-			}
+			OutSessionSettings.Add(Key, Setting);
 		}
 	}
 }
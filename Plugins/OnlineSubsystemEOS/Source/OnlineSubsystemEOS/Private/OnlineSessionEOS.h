@@ -2,12 +2,14 @@
 
 #pragma once
 
-#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include "Containers/IndirectArray.h"
 #include "OnlineSessionSettings.h"
 #include "Interfaces/OnlineSessionInterface.h"
 #include "OnlineSubsystemEOSPackage.h"
 #include "LANBeacon.h"
 #include "OnlineSubsystemEOSTypes.h"
+#include "OnlineExtensionsEOS.h"
 
 class FOnlineSubsystemEOS;
 
@@ -18,6 +20,27 @@ class FOnlineSubsystemEOS;
 
 typedef TEOSCallback<EOS_Sessions_OnUpdateSessionCallback, EOS_Sessions_UpdateSessionCallbackInfo> FUpdateSessionCallback;
 
+/**
+ * Everything a session or lobby update sends to the backend. We keep the last one published per session
+ * so later updates only send the keys that changed and skip the SDK call when nothing did.
+ */
+struct FSessionAttributeSetEOS
+{
+	/** Modification settings that aren't attributes, e.g. the permission level */
+	TMap<FName, FVariantData> Properties;
+	/** Searchable attributes keyed by attribute name */
+	TMap<FName, FVariantData> Attributes;
+	/** Lobbies only: the local member's attributes */
+	TMap<FName, FVariantData> MemberAttributes;
+
+	bool operator==(const FSessionAttributeSetEOS& Other) const
+	{
+		return Properties.OrderIndependentCompareEqual(Other.Properties)
+			&& Attributes.OrderIndependentCompareEqual(Other.Attributes)
+			&& MemberAttributes.OrderIndependentCompareEqual(Other.MemberAttributes);
+	}
+};
+
 struct FSessionSearchEOS
 {
 	EOS_HSessionSearch SearchHandle;
@@ -33,11 +56,68 @@ struct FSessionSearchEOS
 	}
 };
 
+/** Coalescing state for the updates of one session, see FOnlineSessionEOS::QueueSessionUpdate */
+struct FSessionUpdateStateEOS
+{
+	/** UpdateSession calls merged into the next update */
+	int32 NumQueuedCallers = 0;
+	/** UpdateSession calls the update in flight will complete */
+	int32 NumInFlightCallers = 0;
+	bool bInFlight = false;
+	/** FPlatformTime::Seconds() when the last update was sent to the backend */
+	double LastSendTime = 0.0;
+};
+
+/** Search results still waiting to be converted, a batch per tick. See FOnlineSessionEOS::TickSearchResultsStreams */
+struct FSearchResultsStreamEOS
+{
+	TSharedPtr<FOnlineSessionSearch> SearchSettings;
+	int32 NumResults = 0;
+	int32 NextResult = 0;
+	/** Adds the result at an index of the EOS search to SearchSettings */
+	TFunction<void(int32)> ConvertResult;
+	/** Called once, with true when every result was converted or false when the search was cancelled or restarted */
+	TFunction<void(bool)> OnFinished;
+	/** Set for background refreshes of the search cache, whose pages nobody asked for */
+	bool bSilent = false;
+};
+
+/** The last results of one search query, and the backend search refreshing them. See FOnlineSessionEOS::FindSessions */
+struct FSessionSearchCacheEntryEOS
+{
+	TArray<FOnlineSessionSearchResult> SearchResults;
+	bool bHasResults = false;
+	/** FPlatformTime::Seconds() when SearchResults came back */
+	double FetchTime = 0.0;
+	/** The backend search in flight for this query, if any */
+	TSharedPtr<FOnlineSessionSearch> PendingSearch;
+	/** Searches for the same query that are waiting on PendingSearch instead of starting their own */
+	TArray<TSharedRef<FOnlineSessionSearch>> Waiters;
+	/** Whether PendingSearch is a background refresh nobody asked for, so it shouldn't notify */
+	bool bIsRevalidating = false;
+	/** Lobby results point at details handles that are released once a lobby is joined */
+	bool bIsLobbySearch = false;
+};
+
+/** A hosted LAN session's beacon response, serialized once and resent until the session changes. See FOnlineSessionEOS::OnValidQueryPacketReceived */
+struct FLanResponsePacketEOS
+{
+	/** Header and session details, with the client nonce left for each reply to patch in */
+	TArray<uint8> Packet;
+	/** Where the client nonce starts in Packet */
+	int32 NonceOffset = 0;
+	/** The parts of the session that change without an UpdateSession, as they were when Packet was built */
+	int32 NumOpenPrivateConnections = 0;
+	int32 NumOpenPublicConnections = 0;
+	int32 HostPort = 0;
+};
+
 /**
  * Interface for interacting with EOS sessions
  */
 class FOnlineSessionEOS :
-	public IOnlineSession
+	public IOnlineSession,
+	public IOnlineSessionSearchEventsEOS
 {
 public:
 	FOnlineSessionEOS() = delete;
@@ -47,39 +127,40 @@ public:
 
 	FNamedOnlineSession* GetNamedSession(FName SessionName) override
 	{
-		FScopeLock ScopeLock(&SessionLock);
-		for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
-		{
-			if (Sessions[SearchIndex].SessionName == SessionName)
-			{
-				return &Sessions[SearchIndex];
-			}
-		}
-		return nullptr;
+		FRWScopeLock ScopeLock(SessionLock, SLT_ReadOnly);
+		return SessionsByName.FindRef(SessionName);
 	}
 
 	virtual void RemoveNamedSession(FName SessionName) override
 	{
-		FScopeLock ScopeLock(&SessionLock);
-		for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
+		FRWScopeLock ScopeLock(SessionLock, SLT_Write);
+		FNamedOnlineSession* Session = nullptr;
+		if (SessionsByName.RemoveAndCopyValue(SessionName, Session))
 		{
-			if (Sessions[SearchIndex].SessionName == SessionName)
+			uint32 LobbyIdHash = 0;
+			if (LobbyIdHashesByName.RemoveAndCopyValue(SessionName, LobbyIdHash))
+			{
+				LobbySessionsById.RemoveSingle(LobbyIdHash, Session);
+			}
+			for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
 			{
-				Sessions.RemoveAtSwap(SearchIndex);
-				return;
+				if (&Sessions[SearchIndex] == Session)
+				{
+					Sessions.RemoveAtSwap(SearchIndex);
+					break;
+				}
 			}
+			PublishedAttributeSets.Remove(SessionName);
+			LanResponsePackets.Remove(SessionName);
 		}
 	}
 
 	virtual EOnlineSessionState::Type GetSessionState(FName SessionName) const override
 	{
-		FScopeLock ScopeLock(&SessionLock);
-		for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
+		FRWScopeLock ScopeLock(SessionLock, SLT_ReadOnly);
+		if (const FNamedOnlineSession* const* Session = SessionsByName.Find(SessionName))
 		{
-			if (Sessions[SearchIndex].SessionName == SessionName)
-			{
-				return Sessions[SearchIndex].SessionState;
-			}
+			return (*Session)->SessionState;
 		}
 
 		return EOnlineSessionState::NoSession;
@@ -87,7 +168,7 @@ public:
 
 	virtual bool HasPresenceSession() override
 	{
-		FScopeLock ScopeLock(&SessionLock);
+		FRWScopeLock ScopeLock(SessionLock, SLT_ReadOnly);
 		for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
 		{
 			if (Sessions[SearchIndex].SessionSettings.bUsesPresence)
@@ -139,11 +220,20 @@ public:
 // ~IOnlineSession Interface
 
 PACKAGE_SCOPE:
-	/** Critical sections for thread safe operation of session lists */
-	mutable FCriticalSection SessionLock;
+	/** Guards the session list and its indices. Lookups only read, so they take it shared and never block one another */
+	mutable FRWLock SessionLock;
 
-	/** Current session settings */
-	TArray<FNamedOnlineSession> Sessions;
+	/** Current session settings. Each session is allocated separately so the pointers handed out survive other sessions being removed */
+	TIndirectArray<FNamedOnlineSession> Sessions;
+	/** Sessions indexed by name, kept in sync with Sessions */
+	TMap<FName, FNamedOnlineSession*> SessionsByName;
+	/**
+	 * Lobby sessions indexed by the hash of their lobby id, added once the id is known. Look ups hash the id
+	 * they were given in place and confirm it against the session's own id, so no id string is built per look up
+	 */
+	TMultiMap<uint32, FNamedOnlineSession*> LobbySessionsById;
+	/** The LobbySessionsById key each lobby session is indexed under, so it can be removed by key */
+	TMap<FName, uint32> LobbyIdHashesByName;
 
 	/** Current search object */
 	TSharedPtr<FOnlineSessionSearch> CurrentSessionSearch;
@@ -155,6 +245,10 @@ PACKAGE_SCOPE:
 		: CurrentSessionSearch(nullptr)
 		, SessionSearchStartInSeconds(0)
 		, EOSSubsystem(InSubsystem)
+		, SessionUpdateMinInterval(0.0)
+		, SearchResultsBudget(0.0)
+		, SearchCacheTTL(0.0)
+		, bRevalidateStaleSearches(false)
 	{
 	}
 
@@ -166,14 +260,18 @@ PACKAGE_SCOPE:
 	// IOnlineSession
 	class FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings) override
 	{
-		FScopeLock ScopeLock(&SessionLock);
-		return new (Sessions) FNamedOnlineSession(SessionName, SessionSettings);
+		FRWScopeLock ScopeLock(SessionLock, SLT_Write);
+		FNamedOnlineSession* Session = new (Sessions) FNamedOnlineSession(SessionName, SessionSettings);
+		SessionsByName.Add(SessionName, Session);
+		return Session;
 	}
 
 	class FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSession& Session) override
 	{
-		FScopeLock ScopeLock(&SessionLock);
-		return new (Sessions) FNamedOnlineSession(SessionName, Session);
+		FRWScopeLock ScopeLock(SessionLock, SLT_Write);
+		FNamedOnlineSession* NamedSession = new (Sessions) FNamedOnlineSession(SessionName, Session);
+		SessionsByName.Add(SessionName, NamedSession);
+		return NamedSession;
 	}
 
 	void CheckPendingSessionInvite();
@@ -226,9 +324,12 @@ private:
 	// Lobby Update
 	void SetLobbyPermissionLevel(EOS_HLobbyModification LobbyModificationHandle, FNamedOnlineSession* Session);
 	void SetLobbyMaxMembers(EOS_HLobbyModification LobbyModificationHandle, FNamedOnlineSession* Session);
-	void SetLobbyAttributes(EOS_HLobbyModification LobbyModificationHandle, FNamedOnlineSession* Session);
+	void BuildLobbyAttributeSet(FNamedOnlineSession* Session, FSessionAttributeSetEOS& OutAttributeSet);
+	void SetLobbyAttributes(EOS_HLobbyModification LobbyModificationHandle, const FSessionAttributeSetEOS& AttributeSet, const FSessionAttributeSetEOS& PublishedSet);
 	void AddLobbyAttribute(EOS_HLobbyModification LobbyModificationHandle, const EOS_Lobby_AttributeData* Attribute);
+	void RemoveLobbyAttribute(EOS_HLobbyModification LobbyModificationHandle, FName Key);
 	void AddLobbyMemberAttribute(EOS_HLobbyModification LobbyModificationHandle, const EOS_Lobby_AttributeData* Attribute);
+	void RemoveLobbyMemberAttribute(EOS_HLobbyModification LobbyModificationHandle, FName Key);
 
 	// Lobby search
 	void AddLobbySearchAttribute(EOS_HLobbySearch LobbySearchHandle, const EOS_Lobby_AttributeData* Attribute, EOS_EOnlineComparisonOp ComparisonOp);
@@ -243,8 +344,10 @@ private:
 	void GetEpicAccountIdAsync(const EOS_ProductUserId& ProductUserId, const GetEpicAccountIdAsyncCallback& Callback);
 	void RegisterLobbyNotifications();
 	FNamedOnlineSession* GetNamedSessionFromLobbyId(const FUniqueNetIdEOS& LobbyId);
+	void IndexLobbySession(FNamedOnlineSession* Session);
 	bool GetEpicAccountIdFromProductUserId(const EOS_ProductUserId& ProductUserId, EOS_EpicAccountId& EpicAccountId);
 	EOS_ELobbyPermissionLevel GetLobbyPermissionLevelFromSessionSettings(const FOnlineSessionSettings& SessionSettings);
+	EOS_EOnlineSessionPermissionLevel GetPermissionLevelFromSessionSettings(const FOnlineSessionSettings& SessionSettings);
 	uint32_t GetLobbyMaxMembersFromSessionSettings(const FOnlineSessionSettings& SessionSettings);
 
 	// EOS Sessions
@@ -255,6 +358,24 @@ private:
 	uint32 EndEOSSession(FNamedOnlineSession* Session);
 	uint32 DestroyEOSSession(FNamedOnlineSession* Session, const FOnDestroySessionCompleteDelegate& CompletionDelegate);
 	uint32 FindEOSSession(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings);
+
+	// Search result streaming
+	void StartSearchResultsStream(FSearchResultsStreamEOS&& Stream);
+	void ConvertSearchResultsBatch(FSearchResultsStreamEOS* Stream, double StartTime);
+	void FinishSearchResultsStream(FSearchResultsStreamEOS* Stream, bool bCompleted);
+	void TickSearchResultsStreams();
+
+	// Search result caching
+	uint32 FindCachedSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings);
+	uint32 StartBackendSearch(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings);
+	void OnBackendSearchComplete(const TSharedRef<FOnlineSessionSearch>& SearchSettings, bool bWasSuccessful, bool bWasCancelled);
+	void RemoveCachedLobbySearches();
+
+	// Session update scheduling
+	void QueueSessionUpdate(FName SessionName);
+	void DispatchSessionUpdate(FName SessionName, FSessionUpdateStateEOS& UpdateState);
+	void TickSessionUpdates();
+	void OnSessionUpdateComplete(FName SessionName, bool bWasSuccessful);
 	bool SendEOSSessionInvite(FName SessionName, EOS_ProductUserId SenderId, EOS_ProductUserId ReceiverId);
 
 	bool SendSessionInvite(FName SessionName, EOS_ProductUserId SenderId, EOS_ProductUserId ReceiverId);
@@ -270,8 +391,10 @@ private:
 	void SetPermissionLevel(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session);
 	void SetJoinInProgress(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session);
 	void AddAttribute(EOS_HSessionModification SessionModHandle, const EOS_Sessions_AttributeData* Attribute);
-	void SetAttributes(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session);
-	uint32 SharedSessionUpdate(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session, FUpdateSessionCallback* Callback);
+	void RemoveAttribute(EOS_HSessionModification SessionModHandle, FName Key);
+	void BuildSessionAttributeSet(FNamedOnlineSession* Session, FSessionAttributeSetEOS& OutAttributeSet);
+	void SetAttributes(EOS_HSessionModification SessionModHandle, const FSessionAttributeSetEOS& AttributeSet, const FSessionAttributeSetEOS& PublishedSet);
+	uint32 SharedSessionUpdate(EOS_HSessionModification SessionModHandle, FNamedOnlineSession* Session, const FSessionAttributeSetEOS& AttributeSet, FUpdateSessionCallback* Callback);
 
 	void TickLanTasks(float DeltaTime);
 	uint32 CreateLANSession(int32 HostingPlayerNum, FNamedOnlineSession* Session);
@@ -283,6 +406,7 @@ private:
 	void ReadSessionFromPacket(class FNboSerializeFromBufferEOS& Packet, class FOnlineSession* Session);
 	void ReadSettingsFromPacket(class FNboSerializeFromBufferEOS& Packet, FOnlineSessionSettings& SessionSettings);
 	void OnValidQueryPacketReceived(uint8* PacketData, int32 PacketLength, uint64 ClientNonce);
+	FLanResponsePacketEOS& GetLanResponsePacket(FNamedOnlineSession* Session);
 	void OnValidResponsePacketReceived(uint8* PacketData, int32 PacketLength);
 	void OnLANSearchTimeout();
 	static void SetPortFromNetDriver(const FOnlineSubsystemEOS& Subsystem, const TSharedPtr<FOnlineSessionInfo>& SessionInfo);
@@ -293,11 +417,33 @@ private:
 
 	/** Handles advertising sessions over LAN and client searches */
 	TSharedPtr<FLANSession> LANSession;
-	/** EOS handle wrapper to hold onto it for scope of the search */
-	TSharedPtr<FSessionSearchEOS> CurrentSearchHandle;
+	/** Beacon responses for the LAN sessions we host, keyed by session name */
+	TMap<FName, FLanResponsePacketEOS> LanResponsePackets;
 	/** The last accepted invite search. It searches by session id */
 	TSharedPtr<FOnlineSessionSearch> LastInviteSearch;
 
+	/** What we last sent to the backend for each session we publish, keyed by session name */
+	TMap<FName, FSessionAttributeSetEOS> PublishedAttributeSets;
+	/** Pending and in flight updates per session name */
+	TMap<FName, FSessionUpdateStateEOS> SessionUpdateStates;
+	/** Minimum seconds between two updates of the same session */
+	double SessionUpdateMinInterval;
+
+	/**
+	 * Completed searches whose results are still being converted, oldest first. Each search gets its own,
+	 * so a background refresh finishing can't cut off the search a user is waiting on
+	 */
+	TArray<TUniquePtr<FSearchResultsStreamEOS>> SearchResultsStreams;
+	/** Seconds per tick spent converting search results, shared by every stream, 0 for no limit */
+	double SearchResultsBudget;
+
+	/** Results of recent searches, keyed by query. See MakeSessionSearchCacheKey */
+	TMap<FString, FSessionSearchCacheEntryEOS> SessionSearchCache;
+	/** Seconds cached search results are reused for, 0 when the cache is off */
+	double SearchCacheTTL;
+	/** Whether expired results are still returned while being refreshed */
+	bool bRevalidateStaleSearches;
+
 	/** Notification state for SDK events */
 	EOS_NotificationId SessionInviteAcceptedId;
 	FCallbackBase* SessionInviteAcceptedCallback;
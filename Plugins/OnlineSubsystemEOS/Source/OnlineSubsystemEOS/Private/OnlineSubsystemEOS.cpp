@@ -427,6 +427,11 @@ bool FOnlineSubsystemEOS::Tick(float DeltaTime)
 	}
 
 	SessionInterfacePtr->Tick(DeltaTime);
+	UserManager->Tick(DeltaTime);
+	if (SocketSubsystem.IsValid())
+	{
+		SocketSubsystem->OnSDKTick();
+	}
 	FOnlineSubsystemImpl::Tick(DeltaTime);
 
 	return true;
@@ -456,6 +461,10 @@ bool FOnlineSubsystemEOS::Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice&
 	{
 		bWasHandled = UserCloudInterfacePtr->HandleUserCloudExec(InWorld, Cmd, Ar);
 	}
+	else if (SocketSubsystem.IsValid() && FParse::Command(&Cmd, TEXT("P2P")))
+	{
+		bWasHandled = SocketSubsystem->HandleP2PExec(InWorld, Cmd, Ar);
+	}
 	else
 	{
 		bWasHandled = false;
@@ -516,6 +525,16 @@ IOnlineFriendsPtr FOnlineSubsystemEOS::GetFriendsInterface() const
 	return UserManager;
 }
 
+IOnlineSessionSearchEventsEOSPtr FOnlineSubsystemEOS::GetSessionSearchEventsEOS() const
+{
+	return SessionInterfacePtr;
+}
+
+IOnlineFriendsEventsEOSPtr FOnlineSubsystemEOS::GetFriendsEventsEOS() const
+{
+	return UserManager;
+}
+
 IOnlineSharedCloudPtr FOnlineSubsystemEOS::GetSharedCloudInterface() const
 {
 	UE_LOG_ONLINE(Error, TEXT("Shared Cloud Interface Requested"));
@@ -151,6 +151,8 @@ private:
 		: FUniqueNetIdString()
 	{
 		check(Size == EOS_ID_BYTE_SIZE);
+		// Keep RawBytes in sync with the strings, since user look ups are keyed by them
+		FMemory::Memcpy(RawBytes, Bytes, EOS_ID_BYTE_SIZE);
 		EpicAccountIdStr = BytesToHex(Bytes, ID_HALF_BYTE_SIZE);
 		ProductUserIdStr = BytesToHex(Bytes + ID_HALF_BYTE_SIZE, ID_HALF_BYTE_SIZE);
 		UniqueNetIdStr = EpicAccountIdStr + EOS_ID_SEPARATOR + ProductUserIdStr;
@@ -330,6 +332,7 @@ protected:
 	TMap<FString, FString> AdditionalAuthData;
 };
 
+typedef TSharedPtr<FOnlineUserPresence> FOnlineUserPresencePtr;
 typedef TSharedRef<FOnlineUserPresence> FOnlineUserPresenceRef;
 
 /**
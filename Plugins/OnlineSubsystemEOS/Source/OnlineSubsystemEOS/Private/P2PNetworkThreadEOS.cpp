@@ -0,0 +1,312 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "P2PNetworkThreadEOS.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+
+#if WITH_EOS_SDK
+	#include "eos_p2p.h"
+
+FP2PSocketQueuesEOS::FP2PSocketQueuesEOS(EOS_ProductUserId InLocalUserId, const char* InLocalSocketName, uint8 InChannel)
+	: LocalUserId(InLocalUserId)
+	, Channel(InChannel)
+	, UnregisteredEvent(FPlatformProcess::GetSynchEventFromPool())
+{
+	FCStringAnsi::Strncpy(LocalSocketName, InLocalSocketName, EOS_SOCKET_NAME_SIZE);
+}
+
+FP2PSocketQueuesEOS::~FP2PSocketQueuesEOS()
+{
+	// Nobody else can reach us by now, so every queue can be drained from here
+	FP2PPacketEOS* Packet = nullptr;
+	while (Outgoing.Dequeue(Packet))
+	{
+		delete Packet;
+	}
+	while (Completed.Dequeue(Packet))
+	{
+		delete Packet;
+	}
+	while (Incoming.Dequeue(Packet))
+	{
+		delete Packet;
+	}
+	while (FreeIncoming.Dequeue(Packet))
+	{
+		delete Packet;
+	}
+	for (FP2PPacketEOS* FreePacket : FreeOutgoing)
+	{
+		delete FreePacket;
+	}
+	delete SpareIncoming;
+
+	FPlatformProcess::ReturnSynchEventToPool(UnregisteredEvent);
+	UnregisteredEvent = nullptr;
+}
+
+FP2PPacketEOS* FP2PSocketQueuesEOS::AllocOutgoing()
+{
+	FP2PPacketEOS* Packet = FreeOutgoing.Num() > 0 ? FreeOutgoing.Pop(false) : new FP2PPacketEOS();
+	Packet->Result = EOS_EResult::EOS_Success;
+	return Packet;
+}
+
+FP2PNetworkThreadEOS::FP2PNetworkThreadEOS(EOS_HP2P InP2PHandle)
+	: P2PHandle(InP2PHandle)
+	, WakeEvent(FPlatformProcess::GetSynchEventFromPool())
+	, bStopping(false)
+	, Thread(nullptr)
+{
+	Thread = FRunnableThread::Create(this, TEXT("EOSP2PNetworkThread"), 0, TPri_AboveNormal);
+	UE_LOG(LogSocketSubsystemEOS, Log, TEXT("Started P2P network thread"));
+}
+
+FP2PNetworkThreadEOS::~FP2PNetworkThreadEOS()
+{
+	if (Thread != nullptr)
+	{
+		// Kill calls Stop and waits for Run to return
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+uint32 FP2PNetworkThreadEOS::Run()
+{
+	while (!bStopping)
+	{
+		if (!Pump())
+		{
+			WakeEvent->Wait(EOS_P2P_NETWORK_THREAD_IDLE_WAIT_MS);
+		}
+	}
+
+	// Sockets are normally gone by now, but don't leave the SDK calling into any that weren't
+	Pump();
+	for (const FP2PSocketQueuesEOSPtr& Queues : RegisteredSockets)
+	{
+		ShutdownSocket(*Queues);
+	}
+	RegisteredSockets.Empty();
+	return 0;
+}
+
+void FP2PNetworkThreadEOS::Stop()
+{
+	bStopping = true;
+	Wake();
+}
+
+void FP2PNetworkThreadEOS::Wake()
+{
+	WakeEvent->Trigger();
+}
+
+void FP2PNetworkThreadEOS::RegisterSocket(const FP2PSocketQueuesEOSPtr& Queues)
+{
+	check(IsInGameThread());
+
+	PendingRegisters.Enqueue(Queues);
+	Wake();
+}
+
+void FP2PNetworkThreadEOS::UnregisterSocket(const FP2PSocketQueuesEOSPtr& Queues)
+{
+	check(IsInGameThread());
+
+	PendingUnregisters.Enqueue(Queues);
+	Wake();
+	Queues->UnregisteredEvent->Wait();
+}
+
+bool FP2PNetworkThreadEOS::Pump()
+{
+	bool bDidWork = false;
+
+	// Registrations are taken first, so a socket that registers and unregisters before we get to it is still shut down
+	FP2PSocketQueuesEOSPtr Queues;
+	while (PendingRegisters.Dequeue(Queues))
+	{
+		RegisteredSockets.Add(Queues);
+	}
+
+	for (const FP2PSocketQueuesEOSPtr& Registered : RegisteredSockets)
+	{
+		// Send first so a reply queued this frame goes out before we look for more input
+		bDidWork |= ProcessOutgoing(*Registered);
+		bDidWork |= ReceiveAvailable(*Registered);
+	}
+
+	while (PendingUnregisters.Dequeue(Queues))
+	{
+		// Whatever the socket queued before unregistering (e.g. its last sends) still goes out
+		ProcessOutgoing(*Queues);
+		ShutdownSocket(*Queues);
+		RegisteredSockets.RemoveSingleSwap(Queues);
+		Queues->UnregisteredEvent->Trigger();
+		bDidWork = true;
+	}
+	return bDidWork;
+}
+
+bool FP2PNetworkThreadEOS::ProcessOutgoing(FP2PSocketQueuesEOS& Queues)
+{
+	bool bDidWork = false;
+	FP2PPacketEOS* Packet = nullptr;
+	while (Queues.Outgoing.Dequeue(Packet))
+	{
+		EOS_P2P_SocketId SocketId = { };
+		SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
+
+		switch (Packet->Command)
+		{
+			case EP2PCommandEOS::SendPacket:
+			{
+				FCStringAnsi::Strcpy(SocketId.SocketName, Packet->SocketName);
+
+				EOS_P2P_SendPacketOptions Options = { };
+				Options.ApiVersion = EOS_P2P_SENDPACKET_API_LATEST;
+				Options.LocalUserId = Queues.LocalUserId;
+				Options.RemoteUserId = Packet->RemoteUserId;
+				Options.SocketId = &SocketId;
+				Options.bAllowDelayedDelivery = Packet->bAllowDelayedDelivery ? EOS_TRUE : EOS_FALSE;
+				Options.Reliability = Packet->Reliability;
+				Options.Channel = Packet->Channel;
+				Options.DataLengthBytes = Packet->Size;
+				Options.Data = Packet->Data;
+				Packet->Result = EOS_P2P_SendPacket(P2PHandle, &Options);
+				Queues.NumOutgoing.Decrement();
+				break;
+			}
+			case EP2PCommandEOS::AcceptConnection:
+			{
+				FCStringAnsi::Strcpy(SocketId.SocketName, Packet->SocketName);
+
+				EOS_P2P_AcceptConnectionOptions Options = { };
+				Options.ApiVersion = EOS_P2P_ACCEPTCONNECTION_API_LATEST;
+				Options.LocalUserId = Queues.LocalUserId;
+				Options.RemoteUserId = Packet->RemoteUserId;
+				Options.SocketId = &SocketId;
+				Packet->Result = EOS_P2P_AcceptConnection(P2PHandle, &Options);
+				break;
+			}
+			case EP2PCommandEOS::CloseConnection:
+			{
+				FCStringAnsi::Strcpy(SocketId.SocketName, Packet->SocketName);
+
+				EOS_P2P_CloseConnectionOptions Options = { };
+				Options.ApiVersion = EOS_P2P_CLOSECONNECTION_API_LATEST;
+				Options.LocalUserId = Queues.LocalUserId;
+				Options.RemoteUserId = Packet->RemoteUserId;
+				Options.SocketId = &SocketId;
+				Packet->Result = EOS_P2P_CloseConnection(P2PHandle, &Options);
+				break;
+			}
+			case EP2PCommandEOS::AddConnectNotify:
+			{
+				FCStringAnsi::Strcpy(SocketId.SocketName, Queues.LocalSocketName);
+
+				EOS_P2P_AddNotifyPeerConnectionRequestOptions Options = { };
+				Options.ApiVersion = EOS_P2P_ADDNOTIFYPEERCONNECTIONREQUEST_API_LATEST;
+				Options.LocalUserId = Queues.LocalUserId;
+				Options.SocketId = &SocketId;
+				Queues.ConnectNotifyId = EOS_P2P_AddNotifyPeerConnectionRequest(P2PHandle, &Options, Queues.ConnectNotifyCallback, Queues.ConnectNotifyCallback->GetCallbackPtr());
+				break;
+			}
+			case EP2PCommandEOS::AddClosedNotify:
+			{
+				FCStringAnsi::Strcpy(SocketId.SocketName, Queues.LocalSocketName);
+
+				EOS_P2P_AddNotifyPeerConnectionClosedOptions Options = { };
+				Options.ApiVersion = EOS_P2P_ADDNOTIFYPEERCONNECTIONCLOSED_API_LATEST;
+				Options.LocalUserId = Queues.LocalUserId;
+				Options.SocketId = &SocketId;
+				Queues.ClosedNotifyId = EOS_P2P_AddNotifyPeerConnectionClosed(P2PHandle, &Options, Queues.ClosedNotifyCallback, Queues.ClosedNotifyCallback->GetCallbackPtr());
+				break;
+			}
+		}
+
+		// The socket logs failures and reuses the packet when it drains Completed
+		Queues.Completed.Enqueue(Packet);
+		bDidWork = true;
+	}
+	return bDidWork;
+}
+
+bool FP2PNetworkThreadEOS::ReceiveAvailable(FP2PSocketQueuesEOS& Queues)
+{
+	bool bDidWork = false;
+	for (int32 Count = 0; Count < EOS_P2P_RECEIVE_BATCH_SIZE && Queues.NumIncoming.GetValue() < EOS_P2P_NETWORK_THREAD_MAX_QUEUED_PACKETS; Count++)
+	{
+		FP2PPacketEOS* Packet = Queues.SpareIncoming;
+		Queues.SpareIncoming = nullptr;
+		if (Packet == nullptr && !Queues.FreeIncoming.Dequeue(Packet))
+		{
+			Packet = new FP2PPacketEOS();
+		}
+
+		EOS_P2P_ReceivePacketOptions Options = { };
+		Options.ApiVersion = EOS_P2P_RECEIVEPACKET_API_LATEST;
+		Options.LocalUserId = Queues.LocalUserId;
+		Options.MaxDataSizeBytes = EOS_P2P_MAX_PACKET_SIZE;
+		uint8 Channel = Queues.Channel;
+		Options.RequestedChannel = &Channel;
+
+		EOS_P2P_SocketId SocketId;
+		uint32 BytesRead = 0;
+		EOS_EResult Result = EOS_P2P_ReceivePacket(P2PHandle, &Options, &Packet->RemoteUserId, &SocketId, &Channel, Packet->Data, &BytesRead);
+		if (Result != EOS_EResult::EOS_Success)
+		{
+			if (Result != EOS_EResult::EOS_NotFound)
+			{
+				UE_LOG(LogSocketSubsystemEOS, Error, TEXT("Unable to receive data result code = (%s)"), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
+			}
+			Queues.SpareIncoming = Packet;
+			break;
+		}
+
+		FCStringAnsi::Strncpy(Packet->SocketName, SocketId.SocketName, EOS_SOCKET_NAME_SIZE);
+		Packet->Channel = Channel;
+		Packet->Size = int32(BytesRead);
+		Queues.NumIncoming.Increment();
+		Queues.Incoming.Enqueue(Packet);
+		bDidWork = true;
+	}
+	if (bDidWork && Queues.ReadableEvent != nullptr)
+	{
+		Queues.ReadableEvent->Trigger();
+	}
+	return bDidWork;
+}
+
+void FP2PNetworkThreadEOS::ShutdownSocket(FP2PSocketQueuesEOS& Queues)
+{
+	if (Queues.ConnectNotifyId != EOS_INVALID_NOTIFICATIONID)
+	{
+		EOS_P2P_RemoveNotifyPeerConnectionRequest(P2PHandle, Queues.ConnectNotifyId);
+		Queues.ConnectNotifyId = EOS_INVALID_NOTIFICATIONID;
+	}
+	if (Queues.ClosedNotifyId != EOS_INVALID_NOTIFICATIONID)
+	{
+		EOS_P2P_RemoveNotifyPeerConnectionClosed(P2PHandle, Queues.ClosedNotifyId);
+		Queues.ClosedNotifyId = EOS_INVALID_NOTIFICATIONID;
+	}
+
+	EOS_P2P_SocketId SocketId = { };
+	SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
+	FCStringAnsi::Strcpy(SocketId.SocketName, Queues.LocalSocketName);
+
+	EOS_P2P_CloseConnectionsOptions Options = { };
+	Options.ApiVersion = EOS_P2P_CLOSECONNECTIONS_API_LATEST;
+	Options.LocalUserId = Queues.LocalUserId;
+	Options.SocketId = &SocketId;
+
+	EOS_EResult Result = EOS_P2P_CloseConnections(P2PHandle, &Options);
+	UE_LOG(LogSocketSubsystemEOS, Log, TEXT("Closing socket (%s:%u) on the network thread with result (%s)"), UTF8_TO_TCHAR(Queues.LocalSocketName), Queues.Channel, ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
+}
+#endif
@@ -0,0 +1,167 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+#include "SocketEOS.h"
+
+#if WITH_EOS_SDK
+	#if defined(EOS_PLATFORM_BASE_FILE_NAME)
+	#include EOS_PLATFORM_BASE_FILE_NAME
+	#endif
+
+	#include "eos_p2p_types.h"
+
+/** Max sends waiting for the network thread, and received packets waiting for the socket, before the producing side backs off */
+#define EOS_P2P_NETWORK_THREAD_MAX_QUEUED_PACKETS 1024
+
+/** How long the network thread sleeps when it had nothing to do, unless woken earlier */
+#define EOS_P2P_NETWORK_THREAD_IDLE_WAIT_MS 1
+
+class FEvent;
+class FRunnableThread;
+
+/** What the network thread should do with an outgoing entry */
+enum class EP2PCommandEOS : uint8
+{
+	/** Send Data to the remote */
+	SendPacket,
+	/** Accept the remote's connection request */
+	AcceptConnection,
+	/** Close the connection to the remote, after anything queued for it before */
+	CloseConnection,
+	/** Start listening for connection requests on the socket, see FP2PSocketQueuesEOS::ConnectNotifyCallback */
+	AddConnectNotify,
+	/** Start listening for closed connections on the socket, see FP2PSocketQueuesEOS::ClosedNotifyCallback */
+	AddClosedNotify
+};
+
+/** A packet or command handed between the game thread and the network thread */
+struct FP2PPacketEOS
+{
+	EP2PCommandEOS Command = EP2PCommandEOS::SendPacket;
+	/** Who sent it, or who it is going to */
+	EOS_ProductUserId RemoteUserId = nullptr;
+	/** Socket name of the remote end. Copied so the network thread never needs the socket name registry */
+	char SocketName[EOS_SOCKET_NAME_SIZE];
+	uint8 Channel = 0;
+	/** Outgoing only: how the SDK should deliver it */
+	EOS_EPacketReliability Reliability = EOS_EPacketReliability::EOS_PR_UnreliableUnordered;
+	bool bAllowDelayedDelivery = true;
+	/** Outgoing only: what the SDK returned, filled in by the network thread */
+	EOS_EResult Result = EOS_EResult::EOS_Success;
+	/** Number of valid bytes in Data */
+	int32 Size = 0;
+	uint8 Data[EOS_P2P_MAX_PACKET_SIZE];
+};
+
+/**
+ * Everything one socket exchanges with the network thread. Every queue has exactly one producer and one consumer,
+ * so none of them need locks. Packets are recycled instead of being allocated per send/receive
+ */
+struct FP2PSocketQueuesEOS
+{
+	/** Local user, socket and channel the network thread acts for. Fixed once registered */
+	EOS_ProductUserId LocalUserId;
+	char LocalSocketName[EOS_SOCKET_NAME_SIZE];
+	uint8 Channel;
+
+	/** Game thread -> network thread: sends and commands, in the order they were queued */
+	TQueue<FP2PPacketEOS*, EQueueMode::Spsc> Outgoing;
+	/** Network thread -> game thread: handled sends and commands, with the SDK's result */
+	TQueue<FP2PPacketEOS*, EQueueMode::Spsc> Completed;
+	/** Network thread -> game thread: packets received from the SDK */
+	TQueue<FP2PPacketEOS*, EQueueMode::Spsc> Incoming;
+	/** Game thread -> network thread: consumed packets that can be received into again */
+	TQueue<FP2PPacketEOS*, EQueueMode::Spsc> FreeIncoming;
+
+	/** Sends in Outgoing, so a stalled network thread pushes back instead of growing the queue */
+	FThreadSafeCounter NumOutgoing;
+	/** Packets in Incoming, so a socket nobody reads from doesn't grow the queue */
+	FThreadSafeCounter NumIncoming;
+
+	/** Set by the game thread before it queues the matching Add*Notify command. The callbacks still run on the thread ticking the SDK */
+	FConnectNotifyCallback* ConnectNotifyCallback = nullptr;
+	FClosedNotifyCallback* ClosedNotifyCallback = nullptr;
+
+	/** The socket's FSocketEOS::ReadableEvent, triggered by the network thread after it queues into Incoming. Set before registering */
+	FEvent* ReadableEvent = nullptr;
+
+	/** Triggered by the network thread once it has let go of the socket, see FP2PNetworkThreadEOS::UnregisterSocket */
+	FEvent* UnregisteredEvent;
+
+	/** Game thread only: sent packets ready to be reused */
+	TArray<FP2PPacketEOS*> FreeOutgoing;
+
+	/** Network thread only: the socket's notifications */
+	EOS_NotificationId ConnectNotifyId = EOS_INVALID_NOTIFICATIONID;
+	EOS_NotificationId ClosedNotifyId = EOS_INVALID_NOTIFICATIONID;
+	/** Network thread only: a packet it took for a receive that found nothing */
+	FP2PPacketEOS* SpareIncoming = nullptr;
+
+	FP2PSocketQueuesEOS(EOS_ProductUserId InLocalUserId, const char* InLocalSocketName, uint8 InChannel);
+	~FP2PSocketQueuesEOS();
+
+	/** Gets an entry to queue, reusing one the network thread is done with when possible. Game thread only */
+	FP2PPacketEOS* AllocOutgoing();
+};
+
+typedef TSharedPtr<FP2PSocketQueuesEOS, ESPMode::ThreadSafe> FP2PSocketQueuesEOSPtr;
+
+/**
+ * Optional thread that makes every EOS_P2P_* call for the sockets registered with it: sends, receives, accepts, closes and
+ * adding/removing notifications. Sockets only talk to it through their FP2PSocketQueuesEOS, so the game thread never calls
+ * into the P2P interface while it is in use. Enabled for every socket of the subsystem at once by UEOSSettings::bUseP2PNetworkThread
+ */
+class FP2PNetworkThreadEOS
+	: public FRunnable
+{
+public:
+	FP2PNetworkThreadEOS(EOS_HP2P InP2PHandle);
+	virtual ~FP2PNetworkThreadEOS();
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	//~ End FRunnable Interface
+
+	/** Starts servicing a socket's queues. Game thread only */
+	void RegisterSocket(const FP2PSocketQueuesEOSPtr& Queues);
+
+	/**
+	 * Stops servicing a socket's queues. Blocks until the network thread has handled everything already queued, removed the
+	 * socket's notifications and closed its connections, so the notification callbacks can be freed once this returns. Game thread only
+	 */
+	void UnregisterSocket(const FP2PSocketQueuesEOSPtr& Queues);
+
+	/** Wakes the thread early, e.g. once a frame's packets have been queued */
+	void Wake();
+
+private:
+	/** Services every registered socket, returning true if anything moved */
+	bool Pump();
+
+	bool ProcessOutgoing(FP2PSocketQueuesEOS& Queues);
+	bool ReceiveAvailable(FP2PSocketQueuesEOS& Queues);
+
+	/** Removes a socket's notifications and closes its connections */
+	void ShutdownSocket(FP2PSocketQueuesEOS& Queues);
+
+	EOS_HP2P P2PHandle;
+
+	/** Game thread -> network thread: sockets to start and stop servicing */
+	TQueue<FP2PSocketQueuesEOSPtr, EQueueMode::Spsc> PendingRegisters;
+	TQueue<FP2PSocketQueuesEOSPtr, EQueueMode::Spsc> PendingUnregisters;
+
+	/** Network thread only: the sockets being serviced */
+	TArray<FP2PSocketQueuesEOSPtr> RegisteredSockets;
+
+	FEvent* WakeEvent;
+	FThreadSafeBool bStopping;
+	FRunnableThread* Thread;
+};
+#endif
@@ -3,11 +3,21 @@
 #include "SocketEOS.h"
 #include "SocketTypes.h"
 #include "SocketSubsystemEOS.h"
+#include "P2PNetworkThreadEOS.h"
+#include "HAL/Event.h"
 
 #if WITH_EOS_SDK
 	#include "eos_p2p.h"
 #endif
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Packets Sent"), STAT_EOSNetPacketsSent, STATGROUP_EOSNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Sent"), STAT_EOSNetBytesSent, STATGROUP_EOSNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Packets Received"), STAT_EOSNetPacketsReceived, STATGROUP_EOSNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Received"), STAT_EOSNetBytesReceived, STATGROUP_EOSNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Send Failures"), STAT_EOSNetSendFailures, STATGROUP_EOSNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Would Block Polls"), STAT_EOSNetWouldBlockPolls, STATGROUP_EOSNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Receive Ring Depth"), STAT_EOSNetReceiveRingDepth, STATGROUP_EOSNet);
+
 #if WANTS_NP_LOGGING
 
 #include "Windows/AllowWindowsPlatformTypes.h"
@@ -58,13 +68,27 @@ FSocketEOS::FSocketEOS(FSocketSubsystemEOS& InSocketSubsystem, const FString& In
 	: FSocket(ESocketType::SOCKTYPE_Datagram, InSocketDescription, NAME_None)
 	, SocketSubsystem(InSocketSubsystem)
 	, bIsListening(false)
+	, bAggregatePackets(false)
+	, bMayHaveData(true)
+	, ReadableEvent(FPlatformProcess::GetSynchEventFromPool(true))
+	, NumClosedRemotesEvicted(0)
+	, NumWouldBlockPolls(0)
 #if WITH_EOS_SDK
 	, ConnectNotifyCallback(nullptr)
 	, ConnectNotifyId(EOS_INVALID_NOTIFICATIONID)
 	, ClosedNotifyCallback(nullptr)
 	, ClosedNotifyId(EOS_INVALID_NOTIFICATIONID)
+	, ReceiveRingHead(0)
+	, ReceiveRingCount(0)
 #endif
 {
+	ReadableEvent->Trigger();
+
+	FP2PChannelProfileEOS DescriptionProfile;
+	if (FSocketSubsystemEOS::ParseChannelProfile(*InSocketDescription, DescriptionProfile))
+	{
+		ChannelProfile = DescriptionProfile;
+	}
 }
 
 FSocketEOS::~FSocketEOS()
@@ -76,6 +100,10 @@ FSocketEOS::~FSocketEOS()
 		SocketSubsystem.UnbindChannel(LocalAddress);
 		LocalAddress = FInternetAddrEOS();
 	}
+
+	// Close let go of the network thread, so nothing can trigger this anymore
+	FPlatformProcess::ReturnSynchEventToPool(ReadableEvent);
+	ReadableEvent = nullptr;
 }
 
 bool FSocketEOS::Shutdown(ESocketShutdownMode Mode)
@@ -89,37 +117,61 @@ bool FSocketEOS::Close()
 	check(IsInGameThread() && "p2p does not support multithreading");
 
 #if WITH_EOS_SDK
-	if (ConnectNotifyId != EOS_INVALID_NOTIFICATIONID)
+	if (SocketSubsystem.IsUsingNetworkThread())
 	{
-		EOS_P2P_RemoveNotifyPeerConnectionRequest(SocketSubsystem.GetP2PHandle(), ConnectNotifyId);
+		// Queue anything still being aggregated, then wait for the network thread to send it, drop our notifications and close our connections
+		FlushPendingSends();
+		PendingSendFrames.Empty();
+		ReleaseNetworkQueues();
+
+		ClosedRemotes.Empty();
 	}
-	delete ConnectNotifyCallback;
-	ConnectNotifyCallback = nullptr;
-	if (ClosedNotifyId != EOS_INVALID_NOTIFICATIONID)
+	else
 	{
-		EOS_P2P_RemoveNotifyPeerConnectionClosed(SocketSubsystem.GetP2PHandle(), ClosedNotifyId);
-	}
-	delete ClosedNotifyCallback;
-	ClosedNotifyCallback = nullptr;
+		if (ConnectNotifyId != EOS_INVALID_NOTIFICATIONID)
+		{
+			EOS_P2P_RemoveNotifyPeerConnectionRequest(SocketSubsystem.GetP2PHandle(), ConnectNotifyId);
+		}
+		if (ClosedNotifyId != EOS_INVALID_NOTIFICATIONID)
+		{
+			EOS_P2P_RemoveNotifyPeerConnectionClosed(SocketSubsystem.GetP2PHandle(), ClosedNotifyId);
+		}
 
-	if (LocalAddress.IsValid())
-	{
-		EOS_P2P_SocketId SocketId = { };
-		SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
-		FCStringAnsi::Strcpy(SocketId.SocketName, LocalAddress.GetSocketName());
+		// Get anything still being aggregated out before the connections go away
+		FlushPendingSends();
+		PendingSendFrames.Empty();
 
-		EOS_P2P_CloseConnectionsOptions Options = { };
-		Options.ApiVersion = EOS_P2P_CLOSECONNECTIONS_API_LATEST;
-		Options.LocalUserId = SocketSubsystem.GetLocalUserId();
-		Options.SocketId = &SocketId;
+		if (LocalAddress.IsValid())
+		{
+			EOS_P2P_SocketId SocketId = { };
+			SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
+			FCStringAnsi::Strcpy(SocketId.SocketName, LocalAddress.GetSocketName());
 
-		EOS_EResult Result = EOS_P2P_CloseConnections(SocketSubsystem.GetP2PHandle(), &Options);
+			EOS_P2P_CloseConnectionsOptions Options = { };
+			Options.ApiVersion = EOS_P2P_CLOSECONNECTIONS_API_LATEST;
+			Options.LocalUserId = SocketSubsystem.GetLocalUserId();
+			Options.SocketId = &SocketId;
 
-		UE_LOG(LogSocketSubsystemEOS, Log, TEXT("Closing socket (%s) with result (%s)"), *LocalAddress.ToString(true), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
-		NP_LOG(TEXT("[%s] - Closing socket (%s) with result (%s)\r\n"), GetLogPrefix(), *LocalAddress.ToString(true), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
+			EOS_EResult Result = EOS_P2P_CloseConnections(SocketSubsystem.GetP2PHandle(), &Options);
 
-		ClosedRemotes.Empty();
+			UE_LOG(LogSocketSubsystemEOS, Log, TEXT("Closing socket (%s) with result (%s)"), *LocalAddress.ToString(true), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
+			NP_LOG(TEXT("[%s] - Closing socket (%s) with result (%s)\r\n"), GetLogPrefix(), *LocalAddress.ToString(true), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
+
+			ClosedRemotes.Empty();
+		}
 	}
+
+	// Nothing can call these any more
+	delete ConnectNotifyCallback;
+	ConnectNotifyCallback = nullptr;
+	ConnectNotifyId = EOS_INVALID_NOTIFICATIONID;
+	delete ClosedNotifyCallback;
+	ClosedNotifyCallback = nullptr;
+	ClosedNotifyId = EOS_INVALID_NOTIFICATIONID;
+
+	ResetReceiveRing();
+	RemoteAddressCache.Empty();
+	NetworkSendErrors.Empty();
 #endif
 	return true;
 }
@@ -161,12 +213,19 @@ bool FSocketEOS::Bind(const FInternetAddr& Addr)
 
 #if WITH_EOS_SDK
 	EOS_ProductUserId LocalUserId = LocalAddress.GetLocalUserId();
+	// Queues registered for the address we had before binding would receive on the wrong channel
+	ReleaseNetworkQueues();
 #else
 	void* LocalUserId = LocalAddress.GetLocalUserId();
 #endif
 	LocalAddress = EOSAddr;
 	LocalAddress.SetLocalUserId(LocalUserId);
 
+	if (ChannelProfile.IsSet())
+	{
+		SocketSubsystem.SetChannelProfile(LocalAddress, ChannelProfile.GetValue());
+	}
+
 	UE_LOG(LogSocketSubsystemEOS, Verbose, TEXT("Successfully bound socket to address (%s)"), *LocalAddress.ToString(true));
 	NP_LOG(TEXT("[%s] - Successfully bound socket to address (%s)\r\n"), GetLogPrefix(), *LocalAddress.ToString(true));
 	return true;
@@ -217,18 +276,9 @@ bool FSocketEOS::Listen(int32)
 			// In case they disconnected and then reconnected, remove them from our closed list
 			FInternetAddrEOS RemoteAddress(Info->RemoteUserId, Info->SocketId->SocketName, LocalAddress.GetChannel());
 			RemoteAddress.SetLocalUserId(LocalAddress.GetLocalUserId());
-			ClosedRemotes.Remove(RemoteAddress);
+			ClosedRemotes.Remove(FClosedRemoteKeyEOS(RemoteAddress));
 
-			EOS_P2P_SocketId SocketId = { };
-			SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
-			FCStringAnsi::Strcpy(SocketId.SocketName, Info->SocketId->SocketName);
-
-			EOS_P2P_AcceptConnectionOptions Options = { };
-			Options.ApiVersion = EOS_P2P_ACCEPTCONNECTION_API_LATEST;
-			Options.LocalUserId = LocalAddress.GetLocalUserId();
-			Options.RemoteUserId = Info->RemoteUserId;
-			Options.SocketId = &SocketId;
-			EOS_EResult AcceptResult = EOS_P2P_AcceptConnection(SocketSubsystem.GetP2PHandle(), &Options);
+			EOS_EResult AcceptResult = AcceptConnection(Info->RemoteUserId, Info->SocketId->SocketName);
 			if (AcceptResult == EOS_EResult::EOS_Success)
 			{
 				UE_LOG(LogSocketSubsystemEOS, Verbose, TEXT("Accepting connection request from (%s) on socket (%s)"), *RemoteUser, UTF8_TO_TCHAR(Info->SocketId->SocketName));
@@ -245,7 +295,16 @@ bool FSocketEOS::Listen(int32)
 			UE_LOG(LogSocketSubsystemEOS, Warning, TEXT("Ignoring connection request from (%s) on socket (%s)"), *RemoteUser, UTF8_TO_TCHAR(Info->SocketId->SocketName));
 		}
 	};
-	ConnectNotifyId = EOS_P2P_AddNotifyPeerConnectionRequest(SocketSubsystem.GetP2PHandle(), &Options, ConnectNotifyCallback, ConnectNotifyCallback->GetCallbackPtr());
+	if (SocketSubsystem.IsUsingNetworkThread())
+	{
+		// We have an address, so the queues are there
+		EnsureNetworkQueues()->ConnectNotifyCallback = ConnectNotifyCallback;
+		QueueCommand(EP2PCommandEOS::AddConnectNotify, nullptr, nullptr);
+	}
+	else
+	{
+		ConnectNotifyId = EOS_P2P_AddNotifyPeerConnectionRequest(SocketSubsystem.GetP2PHandle(), &Options, ConnectNotifyCallback, ConnectNotifyCallback->GetCallbackPtr());
+	}
 
 	// Need to handle closures too
 	RegisterClosedNotification();
@@ -270,6 +329,34 @@ bool FSocketEOS::HasPendingData(uint32& PendingDataSize)
 	PendingDataSize = 0;
 
 #if WITH_EOS_SDK
+	if (ReceiveRingCount > 0)
+	{
+		const int32 NextPacketSize = PeekReceivedPacketSize();
+		if (NextPacketSize != INDEX_NONE)
+		{
+			PendingDataSize = NextPacketSize;
+			return true;
+		}
+	}
+
+	if (SocketSubsystem.IsUsingNetworkThread())
+	{
+		FP2PSocketQueuesEOS* Queues = EnsureNetworkQueues();
+		FP2PPacketEOS* Packet = nullptr;
+		if (Queues != nullptr && Queues->Incoming.Peek(Packet))
+		{
+			PendingDataSize = Packet->Size;
+			return true;
+		}
+		return false;
+	}
+
+	if (!bMayHaveData)
+	{
+		// Nothing was there when we last asked and the SDK hasn't ticked since
+		return false;
+	}
+
 	EOS_P2P_GetNextReceivedPacketSizeOptions Options = { };
 	Options.ApiVersion = EOS_P2P_GETNEXTRECEIVEDPACKETSIZE_API_LATEST;
 	Options.LocalUserId = LocalAddress.GetLocalUserId();
@@ -279,6 +366,7 @@ bool FSocketEOS::HasPendingData(uint32& PendingDataSize)
 	EOS_EResult Result = EOS_P2P_GetNextReceivedPacketSize(SocketSubsystem.GetP2PHandle(), &Options, &PendingDataSize);
 	if (Result == EOS_EResult::EOS_NotFound)
 	{
+		SetMayHaveData(false);
 		return false;
 	}
 	if (Result != EOS_EResult::EOS_Success)
@@ -380,6 +468,33 @@ bool FSocketEOS::SendTo(const uint8* Data, int32 Count, int32& OutBytesSent, con
 	// Need to handle closures if we are a client and the server closes down on us
 	RegisterClosedNotification();
 
+	if (bAggregatePackets)
+	{
+		if (!AggregatePacket(DestinationAddress, Data, Count))
+		{
+			return false;
+		}
+	}
+	else if (!SendPacket(DestinationAddress, Data, Count))
+	{
+		return false;
+	}
+	RecordPacketSent(DestinationAddress.GetRemoteUserId(), Count);
+	OutBytesSent = Count;
+	return true;
+#else
+	return false;
+#endif
+}
+
+#if WITH_EOS_SDK
+bool FSocketEOS::SendPacket(const FInternetAddrEOS& DestinationAddress, const uint8* Data, int32 Count)
+{
+	if (SocketSubsystem.IsUsingNetworkThread())
+	{
+		return QueuePacket(DestinationAddress, Data, Count);
+	}
+
 	EOS_P2P_SocketId SocketId = { };
 	SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
 	FCStringAnsi::Strcpy(SocketId.SocketName, DestinationAddress.GetSocketName());
@@ -389,26 +504,127 @@ bool FSocketEOS::SendTo(const uint8* Data, int32 Count, int32& OutBytesSent, con
 	Options.LocalUserId = LocalAddress.GetLocalUserId();
 	Options.RemoteUserId = DestinationAddress.GetRemoteUserId();
 	Options.SocketId = &SocketId;
-	Options.bAllowDelayedDelivery = EOS_TRUE;
-	Options.Reliability = EOS_EPacketReliability::EOS_PR_UnreliableUnordered;
+	const FP2PChannelProfileEOS Profile = SocketSubsystem.GetChannelProfile(DestinationAddress);
+	Options.bAllowDelayedDelivery = Profile.bAllowDelayedDelivery ? EOS_TRUE : EOS_FALSE;
+	Options.Reliability = ToEOSPacketReliability(Profile.Reliability);
 	Options.Channel = DestinationAddress.GetChannel();
 	Options.DataLengthBytes = Count;
 	Options.Data = Data;
 	EOS_EResult Result = EOS_P2P_SendPacket(SocketSubsystem.GetP2PHandle(), &Options);
-	NP_LOG(TEXT("[%s] - EOS_P2P_SendPacket() to (%s) result code = (%s)\r\n"), GetLogPrefix(), *Destination.ToString(true), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
+	NP_LOG(TEXT("[%s] - EOS_P2P_SendPacket() to (%s) result code = (%s)\r\n"), GetLogPrefix(), *DestinationAddress.ToString(true), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
 	if (Result != EOS_EResult::EOS_Success)
 	{
-		UE_LOG(LogSocketSubsystemEOS, Error, TEXT("Unable to send data to (%s) result code = (%s)"), *Destination.ToString(true), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
+		UE_LOG(LogSocketSubsystemEOS, Error, TEXT("Unable to send data to (%s) result code = (%s)"), *DestinationAddress.ToString(true), ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
+		RecordSendFailure(DestinationAddress.GetRemoteUserId(), int32(Result));
 
 		// @todo joeg - map EOS codes to UE4's
 		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EINVAL);
 		return false;
 	}
-	OutBytesSent = Count;
 	return true;
-#else
-	return false;
+}
+
+bool FSocketEOS::AggregatePacket(const FInternetAddrEOS& DestinationAddress, const uint8* Data, int32 Count)
+{
+	const int32 FramedSize = EOS_P2P_AGGREGATE_HEADER_SIZE + Count;
+	const int32 MaxFramedSize = EOS_P2P_MAX_PACKET_SIZE - EOS_P2P_AGGREGATE_FRAME_HEADER_SIZE;
+	if (FramedSize > MaxFramedSize)
+	{
+		UE_LOG(LogSocketSubsystemEOS, Warning, TEXT("Unable to send data, data over maximum aggregated size. Amount=[%d/%d] DestinationAddress = (%s)"), Count, MaxFramedSize - EOS_P2P_AGGREGATE_HEADER_SIZE, *DestinationAddress.ToString(true));
+
+		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EMSGSIZE);
+		return false;
+	}
+
+	FPendingSendFrameEOS& Frame = PendingSendFrames.FindOrAdd(DestinationAddress.GetRemoteUserId());
+	if (Frame.FlushError != ESocketErrors::SE_NO_ERROR)
+	{
+		// Packets we already reported as sent never made it, so fail this one to let the caller know
+		SocketSubsystem.SetLastSocketError(Frame.FlushError);
+		Frame.FlushError = ESocketErrors::SE_NO_ERROR;
+		return false;
+	}
+
+	// A frame can only go to one address, so send what we have if this is for a different socket/channel on the same remote
+	if (Frame.Size > 0 && (Frame.Size + FramedSize > EOS_P2P_MAX_PACKET_SIZE || Frame.Destination != DestinationAddress))
+	{
+		if (!FlushPendingSendFrame(Frame))
+		{
+			return false;
+		}
+	}
+	if (Frame.Size == 0)
+	{
+		Frame.Destination = DestinationAddress;
+		Frame.Data[0] = EOS_P2P_AGGREGATE_FRAME_MARKER;
+		Frame.Size = EOS_P2P_AGGREGATE_FRAME_HEADER_SIZE;
+	}
+
+	uint8* Dest = Frame.Data + Frame.Size;
+	Dest[0] = uint8(Count & 0xFF);
+	Dest[1] = uint8((Count >> 8) & 0xFF);
+	if (Count > 0)
+	{
+		FMemory::Memcpy(Dest + EOS_P2P_AGGREGATE_HEADER_SIZE, Data, Count);
+	}
+	Frame.Size += FramedSize;
+
+	return true;
+}
+
+bool FSocketEOS::FlushPendingSendFrame(FPendingSendFrameEOS& Frame)
+{
+	if (Frame.Size == 0)
+	{
+		return true;
+	}
+
+	const bool bSent = SendPacket(Frame.Destination, Frame.Data, Frame.Size);
+	Frame.Size = 0;
+	return bSent;
+}
+#endif
+
+bool FSocketEOS::FlushPendingSends()
+{
+	bool bAllSent = true;
+#if WITH_EOS_SDK
+	for (TPair<EOS_ProductUserId, FPendingSendFrameEOS>& Pair : PendingSendFrames)
+	{
+		if (!FlushPendingSendFrame(Pair.Value))
+		{
+			Pair.Value.FlushError = SocketSubsystem.GetLastErrorCode();
+			bAllSent = false;
+		}
+	}
+
+	if (NetworkQueues.IsValid())
+	{
+		// This is the end of the frame's sends, so don't leave them waiting for the network thread's next poll
+		ProcessCompletedCommands();
+		SocketSubsystem.GetNetworkThread()->Wake();
+	}
 #endif
+	return bAllSent;
+}
+
+void FSocketEOS::SetChannelProfile(const FP2PChannelProfileEOS& Profile)
+{
+	ChannelProfile = Profile;
+	// Having a remote user id means we are bound, otherwise Bind registers it
+	if (LocalAddress.GetRemoteUserId() != nullptr)
+	{
+		SocketSubsystem.SetChannelProfile(LocalAddress, Profile);
+	}
+}
+
+void FSocketEOS::SetPacketAggregation(bool bEnabled)
+{
+	if (bAggregatePackets && !bEnabled)
+	{
+		FlushPendingSends();
+	}
+	bAggregatePackets = bEnabled;
 }
 
 bool FSocketEOS::Send(const uint8* Data, int32 Count, int32& BytesSent)
@@ -442,6 +658,105 @@ bool FSocketEOS::RecvFrom(uint8* Data, int32 BufferSize, int32& BytesRead, FInte
 	}
 
 #if WITH_EOS_SDK
+	TSharedPtr<FInternetAddrEOS> SourceAddress;
+	// Aggregated frames have to be split, which is done from the ring. If that still leaves the ring empty,
+	// the failed SDK read has set LastSocketError, so an empty poll reports SE_EWOULDBLOCK like any other
+	const bool bReceiveThroughRing = bAggregatePackets;
+	if (ReceiveRingCount == 0 && bReceiveThroughRing)
+	{
+		ReceiveBatch(1);
+	}
+
+	if (ReceiveRingCount > 0)
+	{
+		// Serve previously batched packets first so ordering is preserved
+		if (!PopReceivedPacket(Data, BufferSize, BytesRead, SourceAddress))
+		{
+			return false;
+		}
+	}
+	else if (bReceiveThroughRing || !ReceivePacket(Data, BufferSize, BytesRead, SourceAddress))
+	{
+		// Real failures were logged where they happened, this only counts empty polls
+		if (SocketSubsystem.GetLastErrorCode() == ESocketErrors::SE_EWOULDBLOCK)
+		{
+			NumWouldBlockPolls++;
+			INC_DWORD_STAT(STAT_EOSNetWouldBlockPolls);
+		}
+		return false;
+	}
+
+	static_cast<FInternetAddrEOS&>(Source) = *SourceAddress;
+	RecordPacketReceived(SourceAddress->GetRemoteUserId(), BytesRead);
+
+	NP_LOG(TEXT("[%s] - EOS_P2P_ReceivePacket() of size (%d) from (%s)\r\n"), GetLogPrefix(), BytesRead, *SourceAddress->ToString(true));
+	return true;
+#else
+	return false;
+#endif
+}
+
+int32 FSocketEOS::ReceiveBatch(int32 MaxPackets)
+{
+	check(IsInGameThread() && "p2p does not support multithreading");
+
+#if WITH_EOS_SDK
+	if (ReceiveRing.Num() == 0)
+	{
+		ReceiveRing.SetNum(EOS_P2P_RECEIVE_BATCH_SIZE);
+	}
+
+	const int32 Capacity = ReceiveRing.Num();
+	const int32 PacketsToRead = FMath::Min(MaxPackets, Capacity - ReceiveRingCount);
+	// Only packets that make it into the ring count, so dropping one doesn't end the pass. We stop once a read
+	// fails, which leaves LastSocketError saying why (SE_EWOULDBLOCK when the SDK simply had nothing more)
+	for (int32 Count = 0; Count < PacketsToRead; )
+	{
+		FReceivedPacketEOS& Packet = ReceiveRing[(ReceiveRingHead + ReceiveRingCount) % Capacity];
+		if (!ReceivePacket(Packet.Data, EOS_P2P_MAX_PACKET_SIZE, Packet.Size, Packet.Source))
+		{
+			break;
+		}
+		Packet.ReadOffset = 0;
+		if (bAggregatePackets)
+		{
+			if (Packet.Size < EOS_P2P_AGGREGATE_FRAME_HEADER_SIZE || Packet.Data[0] != EOS_P2P_AGGREGATE_FRAME_MARKER)
+			{
+				UE_LOG(LogSocketSubsystemEOS, Warning, TEXT("Dropping packet from (%s) that is not an aggregated frame, both ends must use the same packet aggregation setting"), *Packet.Source->ToString(true));
+				Packet.Source.Reset();
+				continue;
+			}
+			Packet.ReadOffset = EOS_P2P_AGGREGATE_FRAME_HEADER_SIZE;
+		}
+		ReceiveRingCount++;
+		Count++;
+	}
+
+	SET_DWORD_STAT(STAT_EOSNetReceiveRingDepth, ReceiveRingCount);
+
+	return ReceiveRingCount;
+#else
+	return 0;
+#endif
+}
+
+#if WITH_EOS_SDK
+bool FSocketEOS::ReceivePacket(uint8* Data, int32 BufferSize, int32& BytesRead, TSharedPtr<FInternetAddrEOS>& OutSource)
+{
+	BytesRead = 0;
+
+	if (SocketSubsystem.IsUsingNetworkThread())
+	{
+		return DequeueReceivedPacket(Data, BufferSize, BytesRead, OutSource);
+	}
+
+	if (!bMayHaveData)
+	{
+		// Nothing was there when we last asked and the SDK hasn't ticked since
+		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EWOULDBLOCK);
+		return false;
+	}
+
 	EOS_P2P_ReceivePacketOptions Options = { };
 	Options.ApiVersion = EOS_P2P_RECEIVEPACKET_API_LATEST;
 	Options.LocalUserId = LocalAddress.GetLocalUserId();
@@ -451,12 +766,13 @@ bool FSocketEOS::RecvFrom(uint8* Data, int32 BufferSize, int32& BytesRead, FInte
 
 	EOS_ProductUserId RemoteUserId = nullptr;
 	EOS_P2P_SocketId SocketId;
-	
+
 	EOS_EResult Result = EOS_P2P_ReceivePacket(SocketSubsystem.GetP2PHandle(), &Options, &RemoteUserId, &SocketId, &Channel, Data, (uint32*)&BytesRead);
 	NP_LOG(TEXT("[%s] - EOS_P2P_ReceivePacket() for user (%s) and channel (%d) with result code = (%s)\r\n"), GetLogPrefix(), *MakeStringFromProductUserId(LocalAddress.GetLocalUserId()), Channel, ANSI_TO_TCHAR(EOS_EResult_ToString(Result)));
 	if (Result == EOS_EResult::EOS_NotFound)
 	{
 		// No data to read
+		SetMayHaveData(false);
 		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EWOULDBLOCK);
 		return false;
 	}
@@ -469,19 +785,123 @@ bool FSocketEOS::RecvFrom(uint8* Data, int32 BufferSize, int32& BytesRead, FInte
 		return false;
 	}
 
-	FInternetAddrEOS& SourceAddress = static_cast<FInternetAddrEOS&>(Source);
-	SourceAddress.SetLocalUserId(LocalAddress.GetLocalUserId());
-	SourceAddress.SetRemoteUserId(RemoteUserId);
-	SourceAddress.SetSocketName(SocketId.SocketName);
-	SourceAddress.SetChannel(Channel);
+	OutSource = GetCachedRemoteAddress(RemoteUserId, SocketId.SocketName, Channel);
+	return true;
+}
 
-	NP_LOG(TEXT("[%s] - EOS_P2P_ReceivePacket() of size (%d) from (%s)\r\n"), GetLogPrefix(), BytesRead, *SourceAddress.ToString(true));
+TSharedRef<FInternetAddrEOS> FSocketEOS::GetCachedRemoteAddress(EOS_ProductUserId RemoteUserId, const char* SocketName, uint8 Channel)
+{
+	// Product user id handles are owned by the SDK and stable for its lifetime, so they make a cheap key
+	if (TSharedRef<FInternetAddrEOS>* CachedAddress = RemoteAddressCache.Find(RemoteUserId))
+	{
+		FInternetAddrEOS& Address = CachedAddress->Get();
+		if (Address.GetChannel() == Channel && FCStringAnsi::Strcmp(Address.GetSocketName(), SocketName) == 0)
+		{
+			return *CachedAddress;
+		}
+	}
+
+	// Build a new one rather than editing in place, since queued packets may still reference the old address
+	TSharedRef<FInternetAddrEOS> NewAddress = MakeShared<FInternetAddrEOS>();
+	NewAddress->SetLocalUserId(LocalAddress.GetLocalUserId());
+	NewAddress->SetRemoteUserId(RemoteUserId);
+	NewAddress->SetSocketName(SocketName);
+	NewAddress->SetChannel(Channel);
+	RemoteAddressCache.Add(RemoteUserId, NewAddress);
+	return NewAddress;
+}
+
+bool FSocketEOS::PopReceivedPacket(uint8* Data, int32 BufferSize, int32& BytesRead, TSharedPtr<FInternetAddrEOS>& OutSource)
+{
+	FReceivedPacketEOS& Packet = ReceiveRing[ReceiveRingHead];
+	OutSource = Packet.Source;
+
+	const uint8* PacketData = Packet.Data;
+	int32 PacketSize = Packet.Size;
+	if (bAggregatePackets)
+	{
+		const int32 Remaining = Packet.Size - Packet.ReadOffset;
+		const uint8* Header = Packet.Data + Packet.ReadOffset;
+		const int32 FramedSize = Remaining >= EOS_P2P_AGGREGATE_HEADER_SIZE ? (int32(Header[0]) | (int32(Header[1]) << 8)) : INDEX_NONE;
+		if (FramedSize == INDEX_NONE || EOS_P2P_AGGREGATE_HEADER_SIZE + FramedSize > Remaining)
+		{
+			UE_LOG(LogSocketSubsystemEOS, Warning, TEXT("Dropping malformed aggregated frame from (%s). FrameSize = (%d) ReadOffset = (%d)"), *OutSource->ToString(true), Packet.Size, Packet.ReadOffset);
+			AdvanceReceiveRing();
+
+			SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EINVAL);
+			return false;
+		}
+
+		PacketData = Header + EOS_P2P_AGGREGATE_HEADER_SIZE;
+		PacketSize = FramedSize;
+		Packet.ReadOffset += EOS_P2P_AGGREGATE_HEADER_SIZE + FramedSize;
+		if (Packet.ReadOffset >= Packet.Size)
+		{
+			AdvanceReceiveRing();
+		}
+	}
+	else
+	{
+		AdvanceReceiveRing();
+	}
+
+	// The slot may have been recycled above, but nothing writes to it until the next ReceiveBatch
+	if (PacketSize > BufferSize)
+	{
+		UE_LOG(LogSocketSubsystemEOS, Error, TEXT("Unable to receive data, receiving buffer was too small. BufferSize = (%d) PacketSize = (%d)"), BufferSize, PacketSize);
+
+		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EMSGSIZE);
+		return false;
+	}
+	FMemory::Memcpy(Data, PacketData, PacketSize);
+	BytesRead = PacketSize;
 	return true;
-#else
-	return false;
-#endif
 }
 
+int32 FSocketEOS::PeekReceivedPacketSize() const
+{
+	if (ReceiveRingCount == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const FReceivedPacketEOS& Packet = ReceiveRing[ReceiveRingHead];
+	if (!bAggregatePackets)
+	{
+		return Packet.Size;
+	}
+
+	if (Packet.Size - Packet.ReadOffset < EOS_P2P_AGGREGATE_HEADER_SIZE)
+	{
+		return INDEX_NONE;
+	}
+	const uint8* Header = Packet.Data + Packet.ReadOffset;
+	return int32(Header[0]) | (int32(Header[1]) << 8);
+}
+
+void FSocketEOS::AdvanceReceiveRing()
+{
+	FReceivedPacketEOS& Packet = ReceiveRing[ReceiveRingHead];
+	Packet.Source.Reset();
+	Packet.ReadOffset = 0;
+
+	ReceiveRingHead = (ReceiveRingHead + 1) % ReceiveRing.Num();
+	ReceiveRingCount--;
+}
+
+void FSocketEOS::ResetReceiveRing()
+{
+	for (FReceivedPacketEOS& Packet : ReceiveRing)
+	{
+		Packet.Source.Reset();
+		Packet.Size = 0;
+		Packet.ReadOffset = 0;
+	}
+	ReceiveRingHead = 0;
+	ReceiveRingCount = 0;
+}
+#endif
+
 bool FSocketEOS::Recv(uint8* Data, int32 BufferSize, int32& BytesRead, ESocketReceiveFlags::Type Flags)
 {
 	BytesRead = 0;
@@ -491,8 +911,47 @@ bool FSocketEOS::Recv(uint8* Data, int32 BufferSize, int32& BytesRead, ESocketRe
 
 bool FSocketEOS::Wait(ESocketWaitConditions::Type Condition, FTimespan WaitTime)
 {
-	SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EOPNOTSUPP);
-	return false;
+	if (Condition != ESocketWaitConditions::WaitForRead)
+	{
+		// Sends are handed to the SDK or the network thread straight away, so we are always writable
+		return true;
+	}
+
+	if (IsInGameThread())
+	{
+		uint32 PendingDataSize = 0;
+		if (HasPendingData(PendingDataSize))
+		{
+			return true;
+		}
+		if (!SocketSubsystem.IsUsingNetworkThread())
+		{
+			// Packets only arrive when the SDK ticks on this thread, so blocking here could never see a new one
+			return false;
+		}
+	}
+
+	// Off the game thread only the event is read, never the SDK. It wakes us once the SDK has ticked or the network
+	// thread has received something, after which a receive on the game thread may find a packet
+	return ReadableEvent->Wait(WaitTime);
+}
+
+void FSocketEOS::SetMayHaveData(bool bInMayHaveData)
+{
+	bMayHaveData = bInMayHaveData;
+	if (SocketSubsystem.IsUsingNetworkThread())
+	{
+		// The event follows the received queue instead, so an SDK tick alone mustn't wake waiters
+		return;
+	}
+	if (bMayHaveData)
+	{
+		ReadableEvent->Trigger();
+	}
+	else
+	{
+		ReadableEvent->Reset();
+	}
 }
 
 ESocketConnectionState FSocketEOS::GetConnectionState()
@@ -615,8 +1074,34 @@ bool FSocketEOS::Close(const FInternetAddrEOS& RemoteAddress)
 	}
 
 #if WITH_EOS_SDK
+	// Anything still being aggregated for them (e.g. the close bunch) needs to go out first
+	if (FPendingSendFrameEOS* Frame = PendingSendFrames.Find(RemoteAddress.GetRemoteUserId()))
+	{
+		FlushPendingSendFrame(*Frame);
+		PendingSendFrames.Remove(RemoteAddress.GetRemoteUserId());
+	}
+
 	// So we don't reopen a connection by sending to it
-	ClosedRemotes.Add(RemoteAddress);
+	AddClosedRemote(RemoteAddress);
+	RemoteAddressCache.Remove(RemoteAddress.GetRemoteUserId());
+	NetworkSendErrors.Remove(RemoteAddress.GetRemoteUserId());
+	// Their traffic stays in the socket totals, only the per remote row goes
+	RemoteTrafficStats.Remove(RemoteAddress.GetRemoteUserId());
+
+	return CloseConnection(RemoteAddress);
+#else
+	return false;
+#endif
+}
+
+#if WITH_EOS_SDK
+bool FSocketEOS::CloseConnection(const FInternetAddrEOS& RemoteAddress)
+{
+	if (SocketSubsystem.IsUsingNetworkThread())
+	{
+		// Queued behind what we sent them, so the close bunch still goes out first
+		return QueueCommand(EP2PCommandEOS::CloseConnection, RemoteAddress.GetRemoteUserId(), RemoteAddress.GetSocketName());
+	}
 
 	EOS_P2P_SocketId SocketId = { };
 	SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
@@ -639,20 +1124,169 @@ bool FSocketEOS::Close(const FInternetAddrEOS& RemoteAddress)
 		return false;
 	}
 	return true;
-#else
-	return false;
+}
+#endif
+
+void FSocketEOS::RecordPacketSent(const void* RemoteUserId, int32 Count)
+{
+	INC_DWORD_STAT(STAT_EOSNetPacketsSent);
+	INC_DWORD_STAT_BY(STAT_EOSNetBytesSent, Count);
+
+	FP2PTrafficStatsEOS& RemoteStats = RemoteTrafficStats.FindOrAdd(RemoteUserId);
+	RemoteStats.PacketsSent++;
+	RemoteStats.BytesSent += Count;
+	TrafficStats.PacketsSent++;
+	TrafficStats.BytesSent += Count;
+}
+
+void FSocketEOS::RecordPacketReceived(const void* RemoteUserId, int32 Count)
+{
+	INC_DWORD_STAT(STAT_EOSNetPacketsReceived);
+	INC_DWORD_STAT_BY(STAT_EOSNetBytesReceived, Count);
+
+	FP2PTrafficStatsEOS& RemoteStats = RemoteTrafficStats.FindOrAdd(RemoteUserId);
+	RemoteStats.PacketsReceived++;
+	RemoteStats.BytesReceived += Count;
+	TrafficStats.PacketsReceived++;
+	TrafficStats.BytesReceived += Count;
+}
+
+void FSocketEOS::RecordSendFailure(const void* RemoteUserId, int32 Result)
+{
+	INC_DWORD_STAT(STAT_EOSNetSendFailures);
+
+	RemoteTrafficStats.FindOrAdd(RemoteUserId).SendFailures++;
+	TrafficStats.SendFailures++;
+	SendFailuresByResult.FindOrAdd(Result)++;
+}
+
+void FSocketEOS::DumpTrafficStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Socket (%s): PacketsSent=%llu BytesSent=%llu PacketsReceived=%llu BytesReceived=%llu SendFailures=%llu WouldBlockPolls=%llu"),
+		*LocalAddress.ToString(true), TrafficStats.PacketsSent, TrafficStats.BytesSent, TrafficStats.PacketsReceived, TrafficStats.BytesReceived, TrafficStats.SendFailures, NumWouldBlockPolls);
+
+#if WITH_EOS_SDK
+	int32 NumPendingFrames = 0;
+	for (const TPair<EOS_ProductUserId, FPendingSendFrameEOS>& Pair : PendingSendFrames)
+	{
+		NumPendingFrames += Pair.Value.Size > 0 ? 1 : 0;
+	}
+	Ar.Logf(TEXT("  Queues: ReceiveRing=%d PendingAggregatedFrames=%d"), ReceiveRingCount, NumPendingFrames);
+	if (NetworkQueues.IsValid())
+	{
+		Ar.Logf(TEXT("  NetworkThread: Outgoing=%d Incoming=%d"), NetworkQueues->NumOutgoing.GetValue(), NetworkQueues->NumIncoming.GetValue());
+	}
+
+	for (const TPair<int32, uint64>& Pair : SendFailuresByResult)
+	{
+		Ar.Logf(TEXT("  SendFailures (%s) = %llu"), ANSI_TO_TCHAR(EOS_EResult_ToString(EOS_EResult(Pair.Key))), Pair.Value);
+	}
+
+	for (const TPair<const void*, FP2PTrafficStatsEOS>& Pair : RemoteTrafficStats)
+	{
+		const FP2PTrafficStatsEOS& Stats = Pair.Value;
+		Ar.Logf(TEXT("  Remote (%s): PacketsSent=%llu BytesSent=%llu PacketsReceived=%llu BytesReceived=%llu SendFailures=%llu"),
+			*LexToString(EOS_ProductUserId(Pair.Key)), Stats.PacketsSent, Stats.BytesSent, Stats.PacketsReceived, Stats.BytesReceived, Stats.SendFailures);
+	}
 #endif
 }
 
+void FSocketEOS::AppendTrafficStatsCsv(FString& Csv) const
+{
+	const FString SocketName = LocalAddress.ToString(true);
+	auto AppendRow = [&Csv, &SocketName](const FString& Remote, const FP2PTrafficStatsEOS& Stats)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%llu,%llu,%llu,%llu,%llu\n"), *SocketName, *Remote, Stats.PacketsSent, Stats.BytesSent, Stats.PacketsReceived, Stats.BytesReceived, Stats.SendFailures);
+	};
+
+	AppendRow(TEXT("Total"), TrafficStats);
+#if WITH_EOS_SDK
+	for (const TPair<const void*, FP2PTrafficStatsEOS>& Pair : RemoteTrafficStats)
+	{
+		AppendRow(LexToString(EOS_ProductUserId(Pair.Key)), Pair.Value);
+	}
+#endif
+}
+
+void FSocketEOS::ResetTrafficStats()
+{
+	TrafficStats = FP2PTrafficStatsEOS();
+	RemoteTrafficStats.Empty();
+	SendFailuresByResult.Empty();
+	NumWouldBlockPolls = 0;
+}
+
+bool FSocketEOS::WasClosed(const FInternetAddrEOS& RemoteAddress)
+{
+	const FClosedRemoteKeyEOS Key(RemoteAddress);
+	const double* ClosedTime = ClosedRemotes.Find(Key);
+	if (ClosedTime == nullptr)
+	{
+		return false;
+	}
+
+	if (FPlatformTime::Seconds() - *ClosedTime > EOS_P2P_CLOSED_REMOTE_EXPIRY_SECONDS)
+	{
+		ClosedRemotes.Remove(Key);
+		NumClosedRemotesEvicted++;
+		return false;
+	}
+	return true;
+}
+
+void FSocketEOS::AddClosedRemote(const FInternetAddrEOS& RemoteAddress)
+{
+	const FClosedRemoteKeyEOS Key(RemoteAddress);
+	const double Now = FPlatformTime::Seconds();
+
+	if (ClosedRemotes.Num() >= EOS_P2P_MAX_CLOSED_REMOTES && !ClosedRemotes.Contains(Key))
+	{
+		// Only pay for the full walk when we're at the cap. Expired entries go first, then the oldest one
+		const FClosedRemoteKeyEOS* OldestKey = nullptr;
+		double OldestTime = Now;
+		for (auto It = ClosedRemotes.CreateIterator(); It; ++It)
+		{
+			if (Now - It.Value() > EOS_P2P_CLOSED_REMOTE_EXPIRY_SECONDS)
+			{
+				It.RemoveCurrent();
+				NumClosedRemotesEvicted++;
+			}
+			else if (It.Value() <= OldestTime)
+			{
+				OldestKey = &It.Key();
+				OldestTime = It.Value();
+			}
+		}
+
+		if (ClosedRemotes.Num() >= EOS_P2P_MAX_CLOSED_REMOTES && OldestKey != nullptr)
+		{
+			ClosedRemotes.Remove(FClosedRemoteKeyEOS(*OldestKey));
+			NumClosedRemotesEvicted++;
+		}
+	}
+
+	ClosedRemotes.Add(Key, Now);
+}
+
 void FSocketEOS::RegisterClosedNotification()
 {
 #if WITH_EOS_SDK
-	if (ClosedNotifyId != EOS_INVALID_NOTIFICATIONID)
+	if (ClosedNotifyCallback != nullptr)
 	{
 		// Already listening for these events so ignore
 		return;
 	}
-	
+
+	FP2PSocketQueuesEOS* Queues = nullptr;
+	if (SocketSubsystem.IsUsingNetworkThread())
+	{
+		Queues = EnsureNetworkQueues();
+		if (Queues == nullptr)
+		{
+			return;
+		}
+	}
+
 	EOS_P2P_SocketId SocketId = { };
 	SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
 	FCStringAnsi::Strcpy(SocketId.SocketName, LocalAddress.GetSocketName());
@@ -668,9 +1302,205 @@ void FSocketEOS::RegisterClosedNotification()
 		// Add this connection to the list of closed ones
 		FInternetAddrEOS RemoteAddress(Info->RemoteUserId, Info->SocketId->SocketName, LocalAddress.GetChannel());
 		RemoteAddress.SetLocalUserId(LocalAddress.GetLocalUserId());
-		ClosedRemotes.Add(RemoteAddress);
+		AddClosedRemote(RemoteAddress);
+		// They are gone, so there is no point sending what we aggregated for them
+		PendingSendFrames.Remove(Info->RemoteUserId);
+		NetworkSendErrors.Remove(Info->RemoteUserId);
+		RemoteTrafficStats.Remove(Info->RemoteUserId);
 		NP_LOG(TEXT("[%s] - Close connection received for remote address (%s)\r\n"), GetLogPrefix(), *RemoteAddress.ToString(true));
 	};
+	if (Queues != nullptr)
+	{
+		Queues->ClosedNotifyCallback = ClosedNotifyCallback;
+		QueueCommand(EP2PCommandEOS::AddClosedNotify, nullptr, nullptr);
+		return;
+	}
 	ClosedNotifyId = EOS_P2P_AddNotifyPeerConnectionClosed(SocketSubsystem.GetP2PHandle(), &Options, ClosedNotifyCallback, ClosedNotifyCallback->GetCallbackPtr());
 #endif
 }
+
+#if WITH_EOS_SDK
+EOS_EResult FSocketEOS::AcceptConnection(EOS_ProductUserId RemoteUserId, const char* SocketName)
+{
+	if (SocketSubsystem.IsUsingNetworkThread())
+	{
+		return QueueCommand(EP2PCommandEOS::AcceptConnection, RemoteUserId, SocketName) ? EOS_EResult::EOS_Success : EOS_EResult::EOS_InvalidState;
+	}
+
+	EOS_P2P_SocketId SocketId = { };
+	SocketId.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
+	FCStringAnsi::Strcpy(SocketId.SocketName, SocketName);
+
+	EOS_P2P_AcceptConnectionOptions Options = { };
+	Options.ApiVersion = EOS_P2P_ACCEPTCONNECTION_API_LATEST;
+	Options.LocalUserId = LocalAddress.GetLocalUserId();
+	Options.RemoteUserId = RemoteUserId;
+	Options.SocketId = &SocketId;
+	return EOS_P2P_AcceptConnection(SocketSubsystem.GetP2PHandle(), &Options);
+}
+
+FP2PSocketQueuesEOS* FSocketEOS::EnsureNetworkQueues()
+{
+	if (!NetworkQueues.IsValid() && LocalAddress.IsValid())
+	{
+		NetworkQueues = MakeShared<FP2PSocketQueuesEOS, ESPMode::ThreadSafe>(LocalAddress.GetLocalUserId(), LocalAddress.GetSocketName(), LocalAddress.GetChannel());
+		NetworkQueues->ReadableEvent = ReadableEvent;
+		SocketSubsystem.GetNetworkThread()->RegisterSocket(NetworkQueues);
+	}
+	return NetworkQueues.Get();
+}
+
+void FSocketEOS::ReleaseNetworkQueues()
+{
+	if (NetworkQueues.IsValid())
+	{
+		SocketSubsystem.GetNetworkThread()->UnregisterSocket(NetworkQueues);
+		// Log anything that failed on the way out
+		ProcessCompletedCommands();
+		NetworkQueues.Reset();
+	}
+}
+
+bool FSocketEOS::QueuePacket(const FInternetAddrEOS& DestinationAddress, const uint8* Data, int32 Count)
+{
+	FP2PSocketQueuesEOS* Queues = EnsureNetworkQueues();
+	if (Queues == nullptr)
+	{
+		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_NOTINITIALISED);
+		return false;
+	}
+
+	ProcessCompletedCommands();
+	if (const ESocketErrors* SendError = NetworkSendErrors.Find(DestinationAddress.GetRemoteUserId()))
+	{
+		// A packet we already reported as sent never made it, so fail this one to let the caller know
+		SocketSubsystem.SetLastSocketError(*SendError);
+		NetworkSendErrors.Remove(DestinationAddress.GetRemoteUserId());
+		return false;
+	}
+
+	if (Queues->NumOutgoing.GetValue() >= EOS_P2P_NETWORK_THREAD_MAX_QUEUED_PACKETS)
+	{
+		UE_LOG(LogSocketSubsystemEOS, Warning, TEXT("Unable to send data, network thread send queue is full. DestinationAddress = (%s)"), *DestinationAddress.ToString(true));
+		RecordSendFailure(DestinationAddress.GetRemoteUserId(), INDEX_NONE);
+
+		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_ENOBUFS);
+		return false;
+	}
+
+	// Resolved here since channel profiles are game thread only
+	const FP2PChannelProfileEOS Profile = SocketSubsystem.GetChannelProfile(DestinationAddress);
+
+	FP2PPacketEOS* Packet = Queues->AllocOutgoing();
+	Packet->Command = EP2PCommandEOS::SendPacket;
+	Packet->RemoteUserId = DestinationAddress.GetRemoteUserId();
+	FCStringAnsi::Strcpy(Packet->SocketName, DestinationAddress.GetSocketName());
+	Packet->Channel = DestinationAddress.GetChannel();
+	Packet->Reliability = ToEOSPacketReliability(Profile.Reliability);
+	Packet->bAllowDelayedDelivery = Profile.bAllowDelayedDelivery;
+	Packet->Size = Count;
+	if (Count > 0)
+	{
+		FMemory::Memcpy(Packet->Data, Data, Count);
+	}
+
+	Queues->NumOutgoing.Increment();
+	Queues->Outgoing.Enqueue(Packet);
+	return true;
+}
+
+bool FSocketEOS::QueueCommand(EP2PCommandEOS Command, EOS_ProductUserId RemoteUserId, const char* SocketName)
+{
+	FP2PSocketQueuesEOS* Queues = EnsureNetworkQueues();
+	if (Queues == nullptr)
+	{
+		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_NOTINITIALISED);
+		return false;
+	}
+
+	FP2PPacketEOS* Packet = Queues->AllocOutgoing();
+	Packet->Command = Command;
+	Packet->RemoteUserId = RemoteUserId;
+	FCStringAnsi::Strncpy(Packet->SocketName, SocketName != nullptr ? SocketName : "", EOS_SOCKET_NAME_SIZE);
+	Packet->Size = 0;
+	Queues->Outgoing.Enqueue(Packet);
+
+	// Connection changes are rare, so have them handled now rather than on the next poll
+	SocketSubsystem.GetNetworkThread()->Wake();
+	return true;
+}
+
+void FSocketEOS::ProcessCompletedCommands()
+{
+	FP2PPacketEOS* Packet = nullptr;
+	while (NetworkQueues->Completed.Dequeue(Packet))
+	{
+		if (Packet->Result != EOS_EResult::EOS_Success)
+		{
+			const FString RemoteUser = LexToString(Packet->RemoteUserId);
+			switch (Packet->Command)
+			{
+				case EP2PCommandEOS::SendPacket:
+				{
+					UE_LOG(LogSocketSubsystemEOS, Error, TEXT("Unable to send data to (%s) result code = (%s)"), *RemoteUser, ANSI_TO_TCHAR(EOS_EResult_ToString(Packet->Result)));
+					RecordSendFailure(Packet->RemoteUserId, int32(Packet->Result));
+
+					// @todo joeg - map EOS codes to UE4's
+					NetworkSendErrors.Add(Packet->RemoteUserId, ESocketErrors::SE_EINVAL);
+					break;
+				}
+				case EP2PCommandEOS::AcceptConnection:
+				{
+					UE_LOG(LogSocketSubsystemEOS, Error, TEXT("EOS_P2P_AcceptConnection from (%s) on socket (%s) failed with (%s)"), *RemoteUser, UTF8_TO_TCHAR(Packet->SocketName), ANSI_TO_TCHAR(EOS_EResult_ToString(Packet->Result)));
+					break;
+				}
+				case EP2PCommandEOS::CloseConnection:
+				{
+					UE_LOG(LogSocketSubsystemEOS, Error, TEXT("Unable to close socket with remote (%s) due to error (%s)"), *RemoteUser, ANSI_TO_TCHAR(EOS_EResult_ToString(Packet->Result)));
+					break;
+				}
+				default:
+				{
+					break;
+				}
+			}
+		}
+		NetworkQueues->FreeOutgoing.Add(Packet);
+	}
+}
+
+bool FSocketEOS::DequeueReceivedPacket(uint8* Data, int32 BufferSize, int32& BytesRead, TSharedPtr<FInternetAddrEOS>& OutSource)
+{
+	FP2PSocketQueuesEOS* Queues = EnsureNetworkQueues();
+	FP2PPacketEOS* Packet = nullptr;
+	if (Queues == nullptr || !Queues->Incoming.Dequeue(Packet))
+	{
+		ReadableEvent->Reset();
+		// The network thread queues before it triggers, so checking again after the reset can't miss a wake up
+		if (Queues != nullptr && Queues->Incoming.Peek(Packet))
+		{
+			ReadableEvent->Trigger();
+		}
+		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EWOULDBLOCK);
+		return false;
+	}
+	Queues->NumIncoming.Decrement();
+
+	const bool bFits = Packet->Size <= BufferSize;
+	if (bFits)
+	{
+		FMemory::Memcpy(Data, Packet->Data, Packet->Size);
+		BytesRead = Packet->Size;
+		OutSource = GetCachedRemoteAddress(Packet->RemoteUserId, Packet->SocketName, Packet->Channel);
+	}
+	else
+	{
+		UE_LOG(LogSocketSubsystemEOS, Error, TEXT("Unable to receive data, receiving buffer was too small. BufferSize = (%d) PacketSize = (%d)"), BufferSize, Packet->Size);
+
+		SocketSubsystem.SetLastSocketError(ESocketErrors::SE_EMSGSIZE);
+	}
+
+	Queues->FreeIncoming.Enqueue(Packet);
+	return bFits;
+}
+#endif
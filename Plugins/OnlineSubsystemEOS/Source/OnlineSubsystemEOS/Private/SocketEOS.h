@@ -10,6 +10,9 @@
 
 class FOnlineSubsystemEOS;
 class FSocketSubsystemEOS;
+class FEvent;
+struct FP2PSocketQueuesEOS;
+enum class EP2PCommandEOS : uint8;
 
 #define WANTS_NP_LOGGING 0
 
@@ -21,13 +24,96 @@ class FSocketSubsystemEOS;
 	#define NP_LOG(Msg, ...)
 #endif
 
+DECLARE_STATS_GROUP(TEXT("EOSNet"), STATGROUP_EOSNet, STATCAT_Advanced);
+
+/** P2P traffic counters for one remote, or summed over every remote on a socket */
+struct FP2PTrafficStatsEOS
+{
+	uint64 PacketsSent = 0;
+	uint64 BytesSent = 0;
+	uint64 PacketsReceived = 0;
+	uint64 BytesReceived = 0;
+	uint64 SendFailures = 0;
+};
+
+/** Max number of closed remotes a socket remembers before evicting the oldest */
+#define EOS_P2P_MAX_CLOSED_REMOTES 1024
+
+/** Seconds a closed remote is remembered for, after which sending to it may reopen the connection */
+#define EOS_P2P_CLOSED_REMOTE_EXPIRY_SECONDS 300.0
+
+/** Columns written by FSocketEOS::AppendTrafficStatsCsv */
+#define EOS_P2P_TRAFFIC_CSV_HEADER TEXT("Socket,Remote,PacketsSent,BytesSent,PacketsReceived,BytesReceived,SendFailures\n")
+
+/** Default number of packets pulled from the SDK in one batched receive pass */
+#define EOS_P2P_RECEIVE_BATCH_SIZE 64
+
 #if WITH_EOS_SDK
 	#include "eos_p2p_types.h"
 
 	typedef TEOSGlobalCallback<EOS_P2P_OnIncomingConnectionRequestCallback, EOS_P2P_OnIncomingConnectionRequestInfo> FConnectNotifyCallback;
 	typedef TEOSGlobalCallback<EOS_P2P_OnRemoteConnectionClosedCallback, EOS_P2P_OnRemoteConnectionClosedInfo> FClosedNotifyCallback;
+
+/** A preallocated slot in the batched receive ring */
+struct FReceivedPacketEOS
+{
+	/** Who sent the packet. Shared with the socket's remote address cache */
+	TSharedPtr<FInternetAddrEOS> Source;
+	/** Number of valid bytes in Data */
+	int32 Size = 0;
+	/** How far into Data we have read when this slot holds an aggregated frame */
+	int32 ReadOffset = 0;
+	/** The packet payload */
+	uint8 Data[EOS_P2P_MAX_PACKET_SIZE];
+};
+
+/** Bytes in front of each packet packed into an aggregated frame (little endian uint16 length) */
+#define EOS_P2P_AGGREGATE_HEADER_SIZE 2
+
+/**
+ * First byte of every aggregated frame, so frames from a peer that doesn't aggregate (or uses another layout) are
+ * dropped instead of being split into garbage. Change it whenever the frame layout changes
+ */
+#define EOS_P2P_AGGREGATE_FRAME_MARKER 0xA1
+#define EOS_P2P_AGGREGATE_FRAME_HEADER_SIZE 1
+
+/** Outgoing frame that small packets for one remote are packed into until it is full or flushed */
+struct FPendingSendFrameEOS
+{
+	/** Where the frame will be sent */
+	FInternetAddrEOS Destination;
+	/** Number of valid bytes in Data */
+	int32 Size = 0;
+	/** Why the last flush of this frame failed, reported by the next SendTo for the remote since the packets were already accepted */
+	ESocketErrors FlushError = ESocketErrors::SE_NO_ERROR;
+	/** Frame marker followed by length prefixed packets waiting to go out */
+	uint8 Data[EOS_P2P_MAX_PACKET_SIZE];
+};
 #endif
 
+/** Identifies a remote we closed, or that closed on us, for a socket */
+struct FClosedRemoteKeyEOS
+{
+	const void* RemoteUserId;
+	uint8 Channel;
+
+	explicit FClosedRemoteKeyEOS(const FInternetAddrEOS& RemoteAddress)
+		: RemoteUserId(RemoteAddress.GetRemoteUserId())
+		, Channel(RemoteAddress.GetChannel())
+	{
+	}
+
+	friend bool operator==(const FClosedRemoteKeyEOS& A, const FClosedRemoteKeyEOS& B)
+	{
+		return A.RemoteUserId == B.RemoteUserId && A.Channel == B.Channel;
+	}
+
+	friend uint32 GetTypeHash(const FClosedRemoteKeyEOS& Key)
+	{
+		return HashCombine(::GetTypeHash(Key.RemoteUserId), Key.Channel);
+	}
+};
+
 class FSocketEOS
 	: public FSocket
 {
@@ -73,17 +159,137 @@ public:
 
 	void SetLocalAddress(const FInternetAddrEOS& InLocalAddress);
 
+	/** Lets the socket ask the SDK for packets again. Called after the SDK ticks, which is the only time new packets show up */
+	void MarkMayHaveData()
+	{
+		SetMayHaveData(true);
+	}
+
 	bool Close(const FInternetAddrEOS& RemoteAddress);
 
-	bool WasClosed(const FInternetAddrEOS& RemoteAddress)
+	/** @return true if the remote was closed recently enough that sending to it should be refused */
+	bool WasClosed(const FInternetAddrEOS& RemoteAddress);
+
+	/** @return the number of closed remotes dropped because they expired or the table was full */
+	uint64 GetNumClosedRemotesEvicted() const
 	{
-		int32 Index = -1;
-		return ClosedRemotes.Find(RemoteAddress, Index);
+		return NumClosedRemotesEvicted;
 	}
 
 	void RegisterClosedNotification();
 
+	/**
+	 * Drains up to MaxPackets pending packets from the SDK into the receive ring in a single pass.
+	 * RecvFrom and HasPendingData are served from the ring before going back to the SDK.
+	 *
+	 * @param MaxPackets the most packets to read this pass, clamped to the ring capacity
+	 * @return the number of packets waiting in the ring after the pass
+	 */
+	int32 ReceiveBatch(int32 MaxPackets);
+
+	/**
+	 * Turns packet aggregation on or off. When on, SendTo packs packets for the same remote into one
+	 * SDK packet that goes out when full or on FlushPendingSends, and received frames are split back apart.
+	 * Both ends of a connection must use the same setting.
+	 */
+	void SetPacketAggregation(bool bEnabled);
+
+	/**
+	 * Sends every partially filled aggregated frame
+	 *
+	 * @return false if any frame failed to send, in which case LastSocketError is set and the next SendTo to that remote fails too
+	 */
+	bool FlushPendingSends();
+
+	/**
+	 * Sets how the SDK delivers packets on this socket's channel. Registered with the subsystem once we are bound,
+	 * since that is when our channel is known. A profile in the socket description is applied the same way
+	 */
+	void SetChannelProfile(const FP2PChannelProfileEOS& Profile);
+
+	/** @return traffic summed over every remote since the stats were last reset */
+	const FP2PTrafficStatsEOS& GetTrafficStats() const
+	{
+		return TrafficStats;
+	}
+
+	/** Logs the aggregate and per-remote traffic counters along with the current queue depths */
+	void DumpTrafficStats(FOutputDevice& Ar) const;
+
+	/** Appends one CSV row per remote (plus a totals row) in the column order of EOS_P2P_TRAFFIC_CSV_HEADER */
+	void AppendTrafficStatsCsv(FString& Csv) const;
+
+	void ResetTrafficStats();
+
 private:
+	void RecordPacketSent(const void* RemoteUserId, int32 Count);
+	void RecordPacketReceived(const void* RemoteUserId, int32 Count);
+	/** Result is the EOS_EResult of the failed call, or INDEX_NONE when we refused the send ourselves */
+	void RecordSendFailure(const void* RemoteUserId, int32 Result);
+
+	/** Remembers a closed remote, evicting expired or the oldest entries when the table is full */
+	void AddClosedRemote(const FInternetAddrEOS& RemoteAddress);
+
+#if WITH_EOS_SDK
+	/** Hands a single packet to the SDK, setting LastSocketError on failure */
+	bool SendPacket(const FInternetAddrEOS& DestinationAddress, const uint8* Data, int32 Count);
+
+	/** Appends a packet to the remote's pending frame, sending the frame first if the packet won't fit */
+	bool AggregatePacket(const FInternetAddrEOS& DestinationAddress, const uint8* Data, int32 Count);
+
+	/** Sends and empties a pending frame if it has anything in it, setting LastSocketError on failure */
+	bool FlushPendingSendFrame(FPendingSendFrameEOS& Frame);
+
+	/** Copies the next packet in the receive ring out, splitting aggregated frames as needed */
+	bool PopReceivedPacket(uint8* Data, int32 BufferSize, int32& BytesRead, TSharedPtr<FInternetAddrEOS>& OutSource);
+
+	/** Size of the next packet PopReceivedPacket will return, or INDEX_NONE if the ring is empty */
+	int32 PeekReceivedPacketSize() const;
+
+	/** Moves the ring past the packet at its head */
+	void AdvanceReceiveRing();
+
+	/**
+	 * Reads the next packet for our channel straight from the SDK
+	 *
+	 * @return true if a packet was read, false if there was none or the read failed (LastSocketError is set)
+	 */
+	bool ReceivePacket(uint8* Data, int32 BufferSize, int32& BytesRead, TSharedPtr<FInternetAddrEOS>& OutSource);
+
+	/** Returns the cached address for a remote user, only building a new one when the user is new or its socket/channel changed */
+	TSharedRef<FInternetAddrEOS> GetCachedRemoteAddress(EOS_ProductUserId RemoteUserId, const char* SocketName, uint8 Channel);
+
+	/** Drops everything that is waiting in the receive ring */
+	void ResetReceiveRing();
+
+	/** Closes the connection to a remote, through the network thread when it is in use */
+	bool CloseConnection(const FInternetAddrEOS& RemoteAddress);
+
+	/** Accepts a remote's connection request, through the network thread when it is in use (which then logs any failure itself) */
+	EOS_EResult AcceptConnection(EOS_ProductUserId RemoteUserId, const char* SocketName);
+
+	/** Registers our queues with the network thread once we have an address, returning null before then */
+	FP2PSocketQueuesEOS* EnsureNetworkQueues();
+
+	/** Unregisters from the network thread, which sends what we queued, removes our notifications and closes our connections */
+	void ReleaseNetworkQueues();
+
+	/** Hands a packet to the network thread, setting LastSocketError if it is backed up or an earlier send to the remote failed */
+	bool QueuePacket(const FInternetAddrEOS& DestinationAddress, const uint8* Data, int32 Count);
+
+	/** Hands a command to the network thread. SocketName may be null for commands about our own socket */
+	bool QueueCommand(EP2PCommandEOS Command, EOS_ProductUserId RemoteUserId, const char* SocketName);
+
+	/** Takes back what the network thread is done with, logging and recording the calls that failed */
+	void ProcessCompletedCommands();
+
+	/** Like ReceivePacket, but takes the next packet the network thread received for us */
+	bool DequeueReceivedPacket(uint8* Data, int32 BufferSize, int32& BytesRead, TSharedPtr<FInternetAddrEOS>& OutSource);
+#endif
+
+	/** Sets bMayHaveData, keeping ReadableEvent in step for Wait. Game thread only */
+	void SetMayHaveData(bool bInMayHaveData);
+
 	/** Reference to our subsystem */
 	FSocketSubsystemEOS& SocketSubsystem;
 
@@ -93,7 +299,35 @@ private:
 	/** Are we currently listening? */
 	bool bIsListening;
 
-	TArray<FInternetAddrEOS> ClosedRemotes;
+	/** Are small packets packed together into shared SDK packets? */
+	bool bAggregatePackets;
+
+	/** False once the SDK reported nothing for our channel, until it next ticks. Saves asking again every poll */
+	bool bMayHaveData;
+
+	/**
+	 * Manual reset event Wait blocks on. Mirrors bMayHaveData, or whether the network thread has received packets for us when
+	 * it is in use, which is when the network thread triggers it
+	 */
+	FEvent* ReadableEvent;
+
+	/** Delivery settings for our channel, from the socket description or SetChannelProfile */
+	TOptional<FP2PChannelProfileEOS> ChannelProfile;
+
+	/** Remotes that were closed and when, so we don't reopen their connection by sending to them */
+	TMap<FClosedRemoteKeyEOS, double> ClosedRemotes;
+
+	/** Number of closed remotes dropped by expiry or the size cap */
+	uint64 NumClosedRemotesEvicted;
+
+	/** Traffic summed over every remote */
+	FP2PTrafficStatsEOS TrafficStats;
+	/** Traffic per remote user, keyed by its product user id */
+	TMap<const void*, FP2PTrafficStatsEOS> RemoteTrafficStats;
+	/** How often each EOS_EResult failed a send */
+	TMap<int32, uint64> SendFailuresByResult;
+	/** Receives that found nothing waiting */
+	uint64 NumWouldBlockPolls;
 
 #if WITH_EOS_SDK
 	FConnectNotifyCallback* ConnectNotifyCallback;
@@ -101,5 +335,24 @@ private:
 
 	FClosedNotifyCallback* ClosedNotifyCallback;
 	EOS_NotificationId ClosedNotifyId;
+
+	/** Preallocated packet slots filled by ReceiveBatch */
+	TArray<FReceivedPacketEOS> ReceiveRing;
+	/** Index of the oldest packet waiting in the ring */
+	int32 ReceiveRingHead;
+	/** Number of packets waiting in the ring */
+	int32 ReceiveRingCount;
+
+	/** Addresses of remotes we have received from, so we don't rebuild one per packet */
+	TMap<EOS_ProductUserId, TSharedRef<FInternetAddrEOS>> RemoteAddressCache;
+
+	/** Aggregated frames being built per remote. Entries are kept around so their buffers are reused */
+	TMap<EOS_ProductUserId, FPendingSendFrameEOS> PendingSendFrames;
+
+	/** Our queues to the network thread, valid while it is in use and we have an address */
+	TSharedPtr<FP2PSocketQueuesEOS, ESPMode::ThreadSafe> NetworkQueues;
+
+	/** Why the network thread failed a send we already reported as sent, reported by the next SendTo for the remote */
+	TMap<EOS_ProductUserId, ESocketErrors> NetworkSendErrors;
 #endif
 };
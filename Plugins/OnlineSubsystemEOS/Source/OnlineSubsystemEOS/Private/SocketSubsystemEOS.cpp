@@ -3,6 +3,8 @@
 #include "SocketSubsystemEOS.h"
 #include "InternetAddrEOS.h"
 #include "SocketEOS.h"
+#include "P2PNetworkThreadEOS.h"
+#include "EOSSettings.h"
 #include "SocketTypes.h"
 #include "Containers/Ticker.h"
 #include "OnlineSubsystem.h"
@@ -14,11 +16,235 @@
 #include "OnlineSubsystemEOS.h"
 #include "UserManagerEOS.h"
 #include "SocketSubsystemModule.h"
+#include "NetConnectionEOS.h"
+#include "UObject/UObjectIterator.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+/** One interned socket name */
+struct FSocketNameSlotEOS
+{
+	char Name[EOS_SOCKET_NAME_SIZE];
+	/** Addresses holding this name's id. The name is freed when it drops to 0 */
+	std::atomic<int32> RefCount;
+};
+
+/**
+ * Storage for interned socket names. Ids below EOS_MAX_SOCKET_NAMES are fixed slots whose names are read without locking,
+ * which is safe since a name can't be freed while the reader holds a reference. Names past that live in an overflow map
+ * that is only touched under the lock
+ */
+struct FSocketNameRegistryEOS
+{
+	FSocketNameSlotEOS Slots[EOS_MAX_SOCKET_NAMES];
+	/** Fixed slots handed out so far, counting freed ones */
+	int32 NumSlotsUsed;
+	/** Fixed slots that were freed and can be handed out again */
+	TArray<FSocketNameIdEOS> FreeIds;
+	/** Names that didn't fit in the fixed slots */
+	TMap<FSocketNameIdEOS, TUniquePtr<FSocketNameSlotEOS>> OverflowSlots;
+	/** Next never used overflow id */
+	int32 NextOverflowId;
+	/** Overflow ids that were freed and can be handed out again */
+	TArray<FSocketNameIdEOS> FreeOverflowIds;
+	/** Case-insensitive hash of a name to its id(s) */
+	TMultiMap<uint32, FSocketNameIdEOS> HashToId;
+	FCriticalSection Lock;
+
+	FSocketNameRegistryEOS()
+		: NumSlotsUsed(1)
+		, NextOverflowId(EOS_MAX_SOCKET_NAMES)
+	{
+		// Id 0 is reserved for the empty name and never counted
+		Slots[0].Name[0] = '\0';
+		Slots[0].RefCount.store(0);
+	}
+
+	/** The slot for an id. Overflow slots need the lock held */
+	FSocketNameSlotEOS& GetSlot(FSocketNameIdEOS SocketNameId)
+	{
+		if (SocketNameId < EOS_MAX_SOCKET_NAMES)
+		{
+			return Slots[SocketNameId];
+		}
+		return *OverflowSlots.FindChecked(SocketNameId);
+	}
+
+	/** Forgets a name nothing holds any more. Lock must be held */
+	void FreeSlot(FSocketNameIdEOS SocketNameId);
+
+	static FSocketNameRegistryEOS& Get()
+	{
+		// Never destroyed, so addresses that outlive static teardown can still let go of their names
+		static FSocketNameRegistryEOS* Registry = new FSocketNameRegistryEOS();
+		return *Registry;
+	}
+};
+
+static uint32 HashSocketName(const char* SocketName)
+{
+	uint32 Hash = 0;
+	for (const char* Char = SocketName; *Char != '\0'; Char++)
+	{
+		Hash = HashCombine(Hash, uint32(FCharAnsi::ToLower(*Char)));
+	}
+	return Hash;
+}
+
+void FSocketNameRegistryEOS::FreeSlot(FSocketNameIdEOS SocketNameId)
+{
+	HashToId.RemoveSingle(HashSocketName(GetSlot(SocketNameId).Name), SocketNameId);
+	if (SocketNameId < EOS_MAX_SOCKET_NAMES)
+	{
+		FreeIds.Add(SocketNameId);
+	}
+	else
+	{
+		OverflowSlots.Remove(SocketNameId);
+		FreeOverflowIds.Add(SocketNameId);
+	}
+}
+
+/** Packs an address's socket name id and channel into the ChannelProfiles key */
+static uint32 MakeChannelProfileKey(const FInternetAddrEOS& Address)
+{
+	return (uint32(Address.GetSocketNameId()) << 8) | Address.GetChannel();
+}
+
+FSocketNameIdEOS FSocketSubsystemEOS::InternSocketName(const char* SocketName)
+{
+	if (SocketName == nullptr || SocketName[0] == '\0')
+	{
+		return 0;
+	}
+
+	// Match what fits in EOS_P2P_SocketId
+	char Truncated[EOS_SOCKET_NAME_SIZE];
+	FCStringAnsi::Strncpy(Truncated, SocketName, EOS_SOCKET_NAME_SIZE);
+	const uint32 Hash = HashSocketName(Truncated);
+
+	FSocketNameRegistryEOS& Registry = FSocketNameRegistryEOS::Get();
+	FScopeLock ScopeLock(&Registry.Lock);
+
+	for (TMultiMap<uint32, FSocketNameIdEOS>::TConstKeyIterator It(Registry.HashToId, Hash); It; ++It)
+	{
+		FSocketNameSlotEOS& Slot = Registry.GetSlot(It.Value());
+		if (FCStringAnsi::Stricmp(Slot.Name, Truncated) == 0)
+		{
+			Slot.RefCount.fetch_add(1, std::memory_order_relaxed);
+			return It.Value();
+		}
+	}
+
+	FSocketNameIdEOS NewId = 0;
+	FSocketNameSlotEOS* NewSlot = nullptr;
+	if (Registry.FreeIds.Num() > 0 || Registry.NumSlotsUsed < EOS_MAX_SOCKET_NAMES)
+	{
+		NewId = Registry.FreeIds.Num() > 0 ? Registry.FreeIds.Pop(false) : FSocketNameIdEOS(Registry.NumSlotsUsed++);
+		NewSlot = &Registry.Slots[NewId];
+	}
+	else
+	{
+		// The fixed slots are all held, so take the slower path rather than fail. Only running out of ids altogether
+		// (tens of thousands of names held at once) is an error
+		if (Registry.FreeOverflowIds.Num() > 0)
+		{
+			NewId = Registry.FreeOverflowIds.Pop(false);
+		}
+		else if (Registry.NextOverflowId <= int32(MAX_uint16))
+		{
+			NewId = FSocketNameIdEOS(Registry.NextOverflowId++);
+		}
+		else
+		{
+			UE_LOG(LogSocketSubsystemEOS, Error, TEXT("Unable to intern socket name (%s), every socket name id is in use"), UTF8_TO_TCHAR(Truncated));
+			return 0;
+		}
+
+		UE_CLOG(Registry.OverflowSlots.Num() == 0, LogSocketSubsystemEOS, Warning, TEXT("All %d fast socket name slots are in use, further names take a slower path"), EOS_MAX_SOCKET_NAMES);
+		NewSlot = Registry.OverflowSlots.Add(NewId, MakeUnique<FSocketNameSlotEOS>()).Get();
+	}
+
+	FCStringAnsi::Strcpy(NewSlot->Name, Truncated);
+	NewSlot->RefCount.store(1, std::memory_order_relaxed);
+	Registry.HashToId.Add(Hash, NewId);
+	return NewId;
+}
+
+void FSocketSubsystemEOS::AddSocketNameRef(FSocketNameIdEOS SocketNameId)
+{
+	if (SocketNameId == 0)
+	{
+		return;
+	}
+
+	FSocketNameRegistryEOS& Registry = FSocketNameRegistryEOS::Get();
+	if (SocketNameId < EOS_MAX_SOCKET_NAMES)
+	{
+		// The caller's own reference keeps the slot alive, so no lock is needed
+		Registry.Slots[SocketNameId].RefCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	FScopeLock ScopeLock(&Registry.Lock);
+	Registry.GetSlot(SocketNameId).RefCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FSocketSubsystemEOS::ReleaseSocketName(FSocketNameIdEOS SocketNameId)
+{
+	if (SocketNameId == 0)
+	{
+		return;
+	}
+
+	FSocketNameRegistryEOS& Registry = FSocketNameRegistryEOS::Get();
+	if (SocketNameId < EOS_MAX_SOCKET_NAMES)
+	{
+		// Dropping a reference that isn't the last doesn't need the lock. The last one does, so a concurrent
+		// InternSocketName can't find the name between it reaching 0 and being freed
+		std::atomic<int32>& RefCount = Registry.Slots[SocketNameId].RefCount;
+		int32 Current = RefCount.load(std::memory_order_relaxed);
+		while (Current > 1)
+		{
+			if (RefCount.compare_exchange_weak(Current, Current - 1, std::memory_order_release, std::memory_order_relaxed))
+			{
+				return;
+			}
+		}
+	}
+
+	FScopeLock ScopeLock(&Registry.Lock);
+	if (Registry.GetSlot(SocketNameId).RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		Registry.FreeSlot(SocketNameId);
+	}
+}
+
+const char* FSocketSubsystemEOS::GetSocketName(FSocketNameIdEOS SocketNameId)
+{
+	FSocketNameRegistryEOS& Registry = FSocketNameRegistryEOS::Get();
+	if (SocketNameId < EOS_MAX_SOCKET_NAMES)
+	{
+		return Registry.Slots[SocketNameId].Name;
+	}
+
+	// Overflow slots are heap allocated, so the name stays put after we unlock for as long as the caller holds its reference
+	FScopeLock ScopeLock(&Registry.Lock);
+	return Registry.GetSlot(SocketNameId).Name;
+}
 
 FSocketSubsystemEOS::FSocketSubsystemEOS(FOnlineSubsystemEOS* InSubsystemEOS)
 	: SubsystemEOS(InSubsystemEOS)
+	, bUseNetworkThread(UEOSSettings::GetSettings().bUseP2PNetworkThread)
 	, LastSocketError(ESocketErrors::SE_NO_ERROR)
 {
+	for (auto& Words : BoundChannels)
+	{
+		for (std::atomic<uint64>& Word : Words)
+		{
+			Word.store(0);
+		}
+	}
 }
 
 FSocketSubsystemEOS::~FSocketSubsystemEOS() = default;
@@ -36,6 +262,11 @@ void FSocketSubsystemEOS::Shutdown()
 	// Destruct our sockets before we finish destructing, as they maintain a reference to us
 	TrackedSockets.Reset();
 
+#if WITH_EOS_SDK
+	// The sockets have unregistered from it, so nothing is left for it to service
+	NetworkThread.Reset();
+#endif
+
 	if (FSocketSubsystemModule* SocketSubsystem = FModuleManager::GetModulePtr<FSocketSubsystemModule>("Sockets"))
 	{
 		SocketSubsystem->UnregisterSocketSubsystem(EOS_SUBSYSTEM);
@@ -109,7 +340,7 @@ const TCHAR* FSocketSubsystemEOS::GetSocketAPIName() const
 
 ESocketErrors FSocketSubsystemEOS::GetLastErrorCode()
 {
-	return TranslateErrorCode(LastSocketError);
+	return TranslateErrorCode(LastSocketError.load(std::memory_order_relaxed));
 }
 
 ESocketErrors FSocketSubsystemEOS::TranslateErrorCode(int32 Code)
@@ -143,6 +374,15 @@ EOS_HP2P FSocketSubsystemEOS::GetP2PHandle()
 	return SubsystemEOS->P2PHandle;
 }
 
+FP2PNetworkThreadEOS* FSocketSubsystemEOS::GetNetworkThread()
+{
+	if (!NetworkThread.IsValid() && bUseNetworkThread)
+	{
+		NetworkThread = MakeUnique<FP2PNetworkThreadEOS>(GetP2PHandle());
+	}
+	return NetworkThread.Get();
+}
+
 EOS_ProductUserId FSocketSubsystemEOS::GetLocalUserId()
 {
 	if (SubsystemEOS != nullptr)
@@ -195,12 +435,14 @@ TSharedRef<FInternetAddr> FSocketSubsystemEOS::GetLocalBindAddr(const UWorld* co
 
 bool FSocketSubsystemEOS::IsSocketWaitSupported() const
 {
-	return false;
+	// Waits off the game thread only read the socket's readiness event, never the SDK. UNetDriverEOS skips the
+	// IpNetDriver receive thread regardless, since receives still have to happen on the game thread
+	return true;
 }
 
 void FSocketSubsystemEOS::SetLastSocketError(const ESocketErrors NewSocketError)
 {
-	LastSocketError = NewSocketError;
+	LastSocketError.store(NewSocketError, std::memory_order_relaxed);
 }
 
 bool FSocketSubsystemEOS::BindChannel(const FInternetAddrEOS& Address)
@@ -212,15 +454,31 @@ bool FSocketSubsystemEOS::BindChannel(const FInternetAddrEOS& Address)
 	}
 
 	const uint8 Channel = Address.GetChannel();
+	const uint64 ChannelBit = uint64(1) << (Channel % 64);
 
-	FChannelSet& ExistingBoundPorts = BoundAddresses.FindOrAdd(Address.GetSocketName());
-	if (ExistingBoundPorts.Contains(Channel))
+	const FSocketNameIdEOS SocketNameId = Address.GetSocketNameId();
+	if (SocketNameId >= EOS_MAX_SOCKET_NAMES)
+	{
+		// Overflow names have no row of their own, so they take the locked path
+		FScopeLock ScopeLock(&OverflowBoundChannelsLock);
+		uint64& Word = OverflowBoundChannels.FindOrAdd(SocketNameId).Words[Channel / 64];
+		if ((Word & ChannelBit) != 0)
+		{
+			SetLastSocketError(ESocketErrors::SE_EADDRINUSE);
+			return false;
+		}
+		Word |= ChannelBit;
+		return true;
+	}
+
+	// Setting the bit is what claims the channel, so two binds racing for it can't both win
+	const uint64 PreviousBits = BoundChannels[SocketNameId][Channel / 64].fetch_or(ChannelBit);
+	if ((PreviousBits & ChannelBit) != 0)
 	{
 		SetLastSocketError(ESocketErrors::SE_EADDRINUSE);
 		return false;
 	}
 
-	ExistingBoundPorts.Add(Channel);
 	return true;
 }
 
@@ -232,30 +490,162 @@ bool FSocketSubsystemEOS::UnbindChannel(const FInternetAddrEOS& Address)
 		return false;
 	}
 
-	const FString SocketName = Address.GetSocketName();
 	const uint8 Channel = Address.GetChannel();
+	const uint64 ChannelBit = uint64(1) << (Channel % 64);
 
-	// Find our sessions collection of ports
-	FChannelSet* ExistingBoundPorts = BoundAddresses.Find(SocketName);
-	if (!ExistingBoundPorts)
+	// Clear our port and check if we had it bound
+	uint64 PreviousBits = 0;
+	const FSocketNameIdEOS SocketNameId = Address.GetSocketNameId();
+	if (SocketNameId >= EOS_MAX_SOCKET_NAMES)
+	{
+		FScopeLock ScopeLock(&OverflowBoundChannelsLock);
+		if (FChannelBitmapEOS* Bitmap = OverflowBoundChannels.Find(SocketNameId))
+		{
+			PreviousBits = Bitmap->Words[Channel / 64];
+			Bitmap->Words[Channel / 64] &= ~ChannelBit;
+			// The id goes back to the registry once its name is freed, so don't leave an empty entry for the next name to get it
+			bool bAnyBound = false;
+			for (uint64 Word : Bitmap->Words)
+			{
+				bAnyBound |= Word != 0;
+			}
+			if (!bAnyBound)
+			{
+				OverflowBoundChannels.Remove(SocketNameId);
+			}
+		}
+	}
+	else
+	{
+		PreviousBits = BoundChannels[SocketNameId][Channel / 64].fetch_and(~ChannelBit);
+	}
+	if ((PreviousBits & ChannelBit) == 0)
 	{
 		SetLastSocketError(ESocketErrors::SE_ENOTSOCK);
 		return false;
 	}
 
-	// Remove our port and check if we had it bound
-	if (ExistingBoundPorts->Remove(Channel) == 0)
+	// Whoever binds this socket name and channel next starts from the default
+	ChannelProfiles.Remove(MakeChannelProfileKey(Address));
+
+	return true;
+}
+
+void FSocketSubsystemEOS::SetChannelProfile(const FInternetAddrEOS& Address, const FP2PChannelProfileEOS& Profile)
+{
+	ChannelProfiles.Add(MakeChannelProfileKey(Address), Profile);
+}
+
+FP2PChannelProfileEOS FSocketSubsystemEOS::GetChannelProfile(const FInternetAddrEOS& Address) const
+{
+	if (const FP2PChannelProfileEOS* Profile = ChannelProfiles.Find(MakeChannelProfileKey(Address)))
 	{
-		SetLastSocketError(ESocketErrors::SE_ENOTSOCK);
-		return false;
+		return *Profile;
 	}
+	return FP2PChannelProfileEOS();
+}
 
-	// Remove any empty sets
-	if (ExistingBoundPorts->Num() == 0)
+bool FSocketSubsystemEOS::ParseChannelProfile(const TCHAR* Options, FP2PChannelProfileEOS& OutProfile)
+{
+	FString Reliability;
+	bool bAllowDelayedDelivery = true;
+	const bool bHasReliability = FParse::Value(Options, TEXT("P2PReliability="), Reliability);
+	const bool bHasDelayedDelivery = FParse::Bool(Options, TEXT("P2PDelayedDelivery="), bAllowDelayedDelivery);
+	if (!bHasReliability && !bHasDelayedDelivery)
 	{
-		BoundAddresses.Remove(SocketName);
-		ExistingBoundPorts = nullptr;
+		return false;
 	}
 
+	OutProfile = FP2PChannelProfileEOS();
+	OutProfile.bAllowDelayedDelivery = bAllowDelayedDelivery;
+	if (Reliability == TEXT("ReliableOrdered"))
+	{
+		OutProfile.Reliability = EP2PReliabilityEOS::ReliableOrdered;
+	}
+	else if (Reliability == TEXT("ReliableUnordered"))
+	{
+		OutProfile.Reliability = EP2PReliabilityEOS::ReliableUnordered;
+	}
+	else if (bHasReliability && Reliability != TEXT("UnreliableUnordered"))
+	{
+		UE_LOG(LogSocketSubsystemEOS, Warning, TEXT("Unknown P2P reliability (%s), using UnreliableUnordered"), *Reliability);
+	}
 	return true;
 }
+
+void FSocketSubsystemEOS::OnSDKTick()
+{
+	for (const TUniquePtr<FSocketEOS>& Socket : TrackedSockets)
+	{
+		Socket->MarkMayHaveData();
+	}
+}
+
+bool FSocketSubsystemEOS::HandleP2PExec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar)
+{
+	if (FParse::Command(&Cmd, TEXT("STATS")))
+	{
+		for (const TUniquePtr<FSocketEOS>& Socket : TrackedSockets)
+		{
+			Socket->DumpTrafficStats(Ar);
+		}
+
+		for (TObjectIterator<UNetConnectionEOS> It; It; ++It)
+		{
+			if (It->HasAnyFlags(RF_ClassDefaultObject))
+			{
+				continue;
+			}
+
+			const FP2PTrafficStatsEOS& Stats = It->GetP2PTrafficStats();
+			Ar.Logf(TEXT("Connection (%s): PacketsSent=%llu BytesSent=%llu PacketsReceived=%llu BytesReceived=%llu"),
+				*It->LowLevelGetRemoteAddress(true), Stats.PacketsSent, Stats.BytesSent, Stats.PacketsReceived, Stats.BytesReceived);
+		}
+		return true;
+	}
+	else if (FParse::Command(&Cmd, TEXT("CSV")))
+	{
+		FString FileName = FParse::Token(Cmd, false);
+		if (FileName.IsEmpty())
+		{
+			FileName = FPaths::ProfilingDir() / TEXT("EOSNet") / FString::Printf(TEXT("P2PTraffic-%s.csv"), *FDateTime::Now().ToString());
+		}
+
+		FString Csv = EOS_P2P_TRAFFIC_CSV_HEADER;
+		for (const TUniquePtr<FSocketEOS>& Socket : TrackedSockets)
+		{
+			Socket->AppendTrafficStatsCsv(Csv);
+		}
+		for (TObjectIterator<UNetConnectionEOS> It; It; ++It)
+		{
+			if (It->HasAnyFlags(RF_ClassDefaultObject))
+			{
+				continue;
+			}
+
+			const FP2PTrafficStatsEOS& Stats = It->GetP2PTrafficStats();
+			// Send failures are only known to the socket, so connection rows leave that column empty
+			Csv += FString::Printf(TEXT("Connection,%s,%llu,%llu,%llu,%llu,\n"), *It->LowLevelGetRemoteAddress(true), Stats.PacketsSent, Stats.BytesSent, Stats.PacketsReceived, Stats.BytesReceived);
+		}
+
+		if (FFileHelper::SaveStringToFile(Csv, *FileName))
+		{
+			Ar.Logf(TEXT("Wrote P2P traffic stats to (%s)"), *FileName);
+		}
+		else
+		{
+			Ar.Logf(TEXT("Failed to write P2P traffic stats to (%s)"), *FileName);
+		}
+		return true;
+	}
+	else if (FParse::Command(&Cmd, TEXT("RESETSTATS")))
+	{
+		for (const TUniquePtr<FSocketEOS>& Socket : TrackedSockets)
+		{
+			Socket->ResetTrafficStats();
+		}
+		return true;
+	}
+
+	return false;
+}
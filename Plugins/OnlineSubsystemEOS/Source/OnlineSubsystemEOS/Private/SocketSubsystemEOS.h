@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "SocketSubsystem.h"
+#include <atomic>
 
 #if WITH_EOS_SDK
 	#if defined(EOS_PLATFORM_BASE_FILE_NAME)
@@ -21,8 +22,51 @@ class FInternetAddr;
 class FInternetAddrEOS;
 class FSocketEOS;
 class FOnlineSubsystemEOS;
+class FP2PNetworkThreadEOS;
+class UWorld;
 
-typedef TSet<uint8> FChannelSet;
+/** Compact id of an interned socket name. 0 is always the empty name */
+typedef uint16 FSocketNameIdEOS;
+
+/** Socket names that fit in the lock free part of the registry. Names past this still intern, just through a slower locked path */
+#define EOS_MAX_SOCKET_NAMES 1024
+
+/** Number of 64 bit words needed for a bit per uint8 channel */
+#define EOS_CHANNEL_BITMAP_WORDS 4
+
+/** Bit per bound channel of one socket name */
+struct FChannelBitmapEOS
+{
+	uint64 Words[EOS_CHANNEL_BITMAP_WORDS] = { };
+};
+
+/** Delivery guarantees for packets on a P2P channel, mirroring EOS_EPacketReliability */
+enum class EP2PReliabilityEOS : uint8
+{
+	UnreliableUnordered,
+	ReliableUnordered,
+	ReliableOrdered
+};
+
+/** How the SDK delivers packets sent to a channel */
+struct FP2PChannelProfileEOS
+{
+	EP2PReliabilityEOS Reliability = EP2PReliabilityEOS::UnreliableUnordered;
+	/** Let the SDK hold packets while the connection is still being set up rather than dropping them */
+	bool bAllowDelayedDelivery = true;
+};
+
+#if WITH_EOS_SDK
+inline EOS_EPacketReliability ToEOSPacketReliability(EP2PReliabilityEOS Reliability)
+{
+	switch (Reliability)
+	{
+		case EP2PReliabilityEOS::ReliableUnordered: return EOS_EPacketReliability::EOS_PR_ReliableUnordered;
+		case EP2PReliabilityEOS::ReliableOrdered: return EOS_EPacketReliability::EOS_PR_ReliableOrdered;
+	}
+	return EOS_EPacketReliability::EOS_PR_UnreliableUnordered;
+}
+#endif
 
 class FSocketSubsystemEOS
 	: public ISocketSubsystem
@@ -54,15 +98,31 @@ public:
 	virtual bool IsSocketWaitSupported() const override;
 //~ End ISocketSubsystem Interface
 
+	/** Called once per online subsystem tick so sockets that found nothing last time check the SDK again */
+	void OnSDKTick();
+
 	void SetLastSocketError(const ESocketErrors NewSocketError);
 
 #if WITH_EOS_SDK
 	EOS_HP2P GetP2PHandle();
 	EOS_ProductUserId GetLocalUserId();
+
+	/**
+	 * @return the network thread making every P2P call for our sockets, starting it on first use, or null if
+	 * IsUsingNetworkThread is false and sockets call the SDK themselves. Game thread only
+	 */
+	FP2PNetworkThreadEOS* GetNetworkThread();
 #endif
 
+	/** @return true if sockets go through the network thread rather than calling the P2P interface themselves */
+	bool IsUsingNetworkThread() const
+	{
+		return bUseNetworkThread;
+	}
+
 	/**
-	 * Bind our socket name & channel and ensure no other connections are using this combination
+	 * Bind our socket name & channel and ensure no other connections are using this combination.
+	 * Safe to call from any thread. Lock and allocation free unless the name is in the registry's overflow range
 	 *
 	 * @param Address The address to bind to
 	 * @return True if we bound successfully, false if not and LastSocketError will be set with a reason
@@ -70,22 +130,77 @@ public:
 	bool BindChannel(const FInternetAddrEOS& Address);
 
 	/**
-	 * Unbind a previously bound socket name and channel.
+	 * Unbind a previously bound socket name and channel, forgetting its channel profile. Game thread only
 	 *
 	 * @param Address The Address to unbind
 	 * @return True if we released the port successfully, false if not and LastSocketError will be set with a reason
 	 */
 	bool UnbindChannel(const FInternetAddrEOS& Address);
 
+	/**
+	 * Interns a socket name so addresses can hold, hash and compare it as a small integer.
+	 * Names are matched case-insensitively and truncated to what fits in an EOS socket id.
+	 * Names are reference counted and freed once nothing holds them, so transient names such as session ids don't pile up.
+	 * Once the first EOS_MAX_SOCKET_NAMES are in use, new names go to a slower locked overflow range rather than failing
+	 *
+	 * @param SocketName the name to intern
+	 * @return the id for the name, holding a reference the caller must give back with ReleaseSocketName, or 0 if the name is empty
+	 */
+	static FSocketNameIdEOS InternSocketName(const char* SocketName);
+
+	/** Takes another reference to an id the caller already holds one to. Safe to call from any thread */
+	static void AddSocketNameRef(FSocketNameIdEOS SocketNameId);
+
+	/** Gives back a reference from InternSocketName or AddSocketNameRef, freeing the name if it was the last. Safe to call from any thread */
+	static void ReleaseSocketName(FSocketNameIdEOS SocketNameId);
+
+	/** @return the interned name for an id the caller holds a reference to. Safe to call from any thread */
+	static const char* GetSocketName(FSocketNameIdEOS SocketNameId);
+
+	/**
+	 * Sets how packets sent to a channel are delivered. Channels without a profile are unreliable and unordered,
+	 * which is what UE's own reliability layer expects, so only side channels that don't layer their own should change this
+	 */
+	void SetChannelProfile(const FInternetAddrEOS& Address, const FP2PChannelProfileEOS& Profile);
+
+	/** @return the profile for the address's socket name and channel, or the default unreliable one if none was set */
+	FP2PChannelProfileEOS GetChannelProfile(const FInternetAddrEOS& Address) const;
+
+	/**
+	 * Reads a channel profile from an options string such as a socket description or URL options.
+	 * Understands P2PReliability=UnreliableUnordered|ReliableUnordered|ReliableOrdered and P2PDelayedDelivery=true|false
+	 *
+	 * @return true if the options named a profile, in which case OutProfile holds it
+	 */
+	static bool ParseChannelProfile(const TCHAR* Options, FP2PChannelProfileEOS& OutProfile);
+
+	/** Handles the P2P console commands: STATS, CSV [FileName] and RESETSTATS */
+	bool HandleP2PExec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar);
+
 private:
 	FOnlineSubsystemEOS* SubsystemEOS;
 
+#if WITH_EOS_SDK
+	/** Services the P2P calls of every socket when the network thread is in use. Declared before the sockets so it outlives them */
+	TUniquePtr<FP2PNetworkThreadEOS> NetworkThread;
+#endif
+
+	/** UEOSSettings::bUseP2PNetworkThread, read once so every socket agrees on who makes the P2P calls */
+	bool bUseNetworkThread;
+
 	/** All sockets allocated by this subsystem */
 	TArray<TUniquePtr<FSocketEOS>> TrackedSockets;
 
-	/** All bound socket addresses */
-	TMap<FString, FChannelSet> BoundAddresses;
+	/** Bit per bound channel, indexed by interned socket name id */
+	std::atomic<uint64> BoundChannels[EOS_MAX_SOCKET_NAMES][EOS_CHANNEL_BITMAP_WORDS];
+
+	/** Bound channels of names in the registry's overflow range, which don't have a row in BoundChannels */
+	TMap<FSocketNameIdEOS, FChannelBitmapEOS> OverflowBoundChannels;
+	FCriticalSection OverflowBoundChannelsLock;
+
+	/** Delivery settings for channels that don't use the default, keyed by socket name id and channel (see MakeChannelProfileKey) */
+	TMap<uint32, FP2PChannelProfileEOS> ChannelProfiles;
 
-	/** The last error we received */
-	ESocketErrors LastSocketError;
+	/** The last error we received. Atomic since BindChannel may set it off the game thread */
+	std::atomic<ESocketErrors> LastSocketError;
 };
@@ -139,7 +139,21 @@ FUserManagerEOS::FUserManagerEOS(FOnlineSubsystemEOS* InSubsystem)
 	, FriendsNotificationCallback(nullptr)
 	, PresenceNotificationId(0)
 	, PresenceNotificationCallback(nullptr)
+	, bIsEpicAccountIdQueryScheduled(false)
+	, NumUserInfoQueriesInFlight(0)
+	, MaxConcurrentUserInfoQueries(UEOSSettings::GetSettings().MaxConcurrentUserInfoQueries)
+	, UserInfoCacheTTL(0.0)
+	, bIsPresenceUpdateScheduled(false)
+	, PresenceUpdateBudget(UEOSSettings::GetSettings().PresenceUpdateBudgetInMilliseconds / 1000.0)
+	, SetPresenceMinInterval(UEOSSettings::GetSettings().SetPresenceMinIntervalInMilliseconds / 1000.0)
 {
+	const FEOSSettings& Settings = UEOSSettings::GetSettings();
+	if (Settings.UserInfoCacheTTLInMilliseconds > 0 && Settings.UserInfoCacheMaxEntries > 0)
+	{
+		UserInfoCacheTTL = Settings.UserInfoCacheTTLInMilliseconds / 1000.0;
+		UserInfoReadTimes.Empty(Settings.UserInfoCacheMaxEntries);
+	}
+
 	// This delegate would cause a crash when running a dedicated server
 	if (!IsRunningDedicatedServer())
 	{
@@ -166,6 +180,11 @@ FUserManagerEOS::~FUserManagerEOS()
 	delete DisplaySettingsUpdatedCallback;
 }
 
+void FUserManagerEOS::Tick(float DeltaTime)
+{
+	TickPresencePublishes();
+}
+
 void FUserManagerEOS::LoginStatusChanged(const EOS_Auth_LoginStatusChangedCallbackInfo* Data)
 {
 	if (Data->CurrentStatus == EOS_ELoginStatus::EOS_LS_NotLoggedIn)
@@ -704,10 +723,11 @@ void FUserManagerEOS::FullLoginCallback(int32 LocalUserNum, EOS_EpicAccountId Ac
 		PresenceNotificationCallback = CallbackObj;
 		CallbackObj->CallbackLambda = [LocalUserNum, this](const EOS_Presence_PresenceChangedCallbackInfo* Data)
 		{
-			if (EpicAccountIdToOnlineUserMap.Contains(Data->PresenceUserId))
+			const FUserRecordEOS* Record = FindUserRecord(Data->PresenceUserId);
+			if (Record != nullptr && Record->OnlineUser.IsValid())
 			{
-				// Update the presence data to the most recent
-				UpdatePresence(Data->PresenceUserId);
+				// Update the presence data to the most recent, once per user per tick
+				QueuePresenceUpdate(Data->PresenceUserId);
 				return;
 			}
 		};
@@ -772,7 +792,7 @@ bool FUserManagerEOS::Logout(int32 LocalUserNum)
 
 	EOS_Auth_LogoutOptions LogoutOptions = { };
 	LogoutOptions.ApiVersion = EOS_AUTH_LOGOUT_API_LATEST;
-	LogoutOptions.LocalUserId = StringToAccountIdMap[UserId->UniqueNetIdStr];
+	LogoutOptions.LocalUserId = GetEpicAccountId(*UserId);
 
 	EOS_Auth_Logout(EOSSubsystem->AuthHandle, &LogoutOptions, CallbackObj, CallbackObj->GetCallbackPtr());
 
@@ -818,30 +838,25 @@ void FUserManagerEOS::AddLocalUser(int32 LocalUserNum, EOS_EpicAccountId EpicAcc
 	UserNumToNetIdMap.Emplace(LocalUserNum, UserNetId);
 	UserNumToAccountIdMap.Emplace(LocalUserNum, EpicAccountId);
 	AccountIdToUserNumMap.Emplace(EpicAccountId, LocalUserNum);
-	NetIdStringToOnlineUserMap.Emplace(*NetId, UserAccountRef);
-	StringToUserAccountMap.Emplace(NetId, UserAccountRef);
-	AccountIdToStringMap.Emplace(EpicAccountId, NetId);
-	ProductUserIdToStringMap.Emplace(UserId, *NetId);
-	StringToAccountIdMap.Emplace(NetId, EpicAccountId);
-	EpicAccountIdToAttributeAccessMap.Emplace(EpicAccountId, UserAccountRef);
 	UserNumToProductUserIdMap.Emplace(LocalUserNum, UserId);
 	ProductUserIdToUserNumMap.Emplace(UserId, LocalUserNum);
-	StringToProductUserIdMap.Emplace(NetId, UserId);
+
+	FUserRecordEOS& Record = FindOrAddUserRecord(FUniqueNetIdKeyEOS(*UserNetId), EpicAccountId, UserId);
+	Record.UserAccount = UserAccountRef;
+	Record.OnlineUser = UserAccountRef;
+	Record.AttributeAccess = UserAccountRef;
 
 	// Init player lists
 	FFriendsListEOSRef FriendsList = MakeShareable(new FFriendsListEOS(LocalUserNum, UserNetId));
 	LocalUserNumToFriendsListMap.Emplace(LocalUserNum, FriendsList);
-	NetIdStringToFriendsListMap.Emplace(NetId, FriendsList);
 	ReadFriendsList(LocalUserNum, FString());
 
 	FBlockedPlayersListEOSRef BlockedPlayersList = MakeShareable(new FBlockedPlayersListEOS(LocalUserNum, UserNetId));
 	LocalUserNumToBlockedPlayerListMap.Emplace(LocalUserNum, BlockedPlayersList);
-	NetIdStringToBlockedPlayerListMap.Emplace(NetId, BlockedPlayersList);
 	QueryBlockedPlayers(*UserNetId);
 
 	FRecentPlayersListEOSRef RecentPlayersList = MakeShareable(new FRecentPlayersListEOS(LocalUserNum, UserNetId));
 	LocalUserNumToRecentPlayerListMap.Emplace(LocalUserNum, RecentPlayersList);
-	NetIdStringToRecentPlayerListMap.Emplace(NetId, RecentPlayersList);
 
 	// Get auth token info
 	EOS_Auth_Token* AuthToken = nullptr;
@@ -879,24 +894,16 @@ void FUserManagerEOS::UpdateUserInfo(IAttributeAccessInterfaceRef AttributeAcces
 
 bool FUserManagerEOS::IsFriendQueryUserInfoOngoing(int32 LocalUserNum)
 {
-	// If we have an entry for this user and the corresponding array has any element, users are still being processed
-	if (IsFriendQueryUserInfoOngoingForLocalUserMap.Contains(LocalUserNum))
-	{
-		return IsFriendQueryUserInfoOngoingForLocalUserMap[LocalUserNum].Num() > 0;
-	}
-
-	return false;
+	// If we have a count for this user that hasn't dropped to zero, users are still being processed
+	return NumUserInfoReadsOngoingForLocalUserMap.FindRef(LocalUserNum) > 0;
 }
 
 TSharedPtr<FUserOnlineAccount> FUserManagerEOS::GetUserAccount(const FUniqueNetId& UserId) const
 {
-	TSharedPtr<FUserOnlineAccount> Result;
-
-	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(UserId);
-	const FUserOnlineAccountEOSRef* FoundUserAccount = StringToUserAccountMap.Find(EOSID.UniqueNetIdStr);
-	if (FoundUserAccount != nullptr)
+	const FUserRecordEOS* Record = FindUserRecord(UserId);
+	if (Record != nullptr)
 	{
-		return *FoundUserAccount;
+		return Record->UserAccount;
 	}
 
 	return nullptr;
@@ -906,9 +913,12 @@ TArray<TSharedPtr<FUserOnlineAccount>> FUserManagerEOS::GetAllUserAccounts() con
 {
 	TArray<TSharedPtr<FUserOnlineAccount>> Result;
 
-	for (TMap<FString, FUserOnlineAccountEOSRef>::TConstIterator It(StringToUserAccountMap); It; ++It)
+	for (const FUserRecordEOS& Record : UserRecords)
 	{
-		Result.Add(It.Value());
+		if (Record.UserAccount.IsValid())
+		{
+			Result.Add(Record.UserAccount);
+		}
 	}
 	return Result;
 }
@@ -920,13 +930,12 @@ FUniqueNetIdPtr FUserManagerEOS::GetUniquePlayerId(int32 LocalUserNum) const
 
 int32 FUserManagerEOS::GetLocalUserNumFromUniqueNetId(const FUniqueNetId& NetId) const
 {
-	const FUniqueNetIdEOS& EosId = FUniqueNetIdEOS::Cast(NetId);
-	if (StringToAccountIdMap.Contains(EosId.UniqueNetIdStr))
+	const FUserRecordEOS* Record = FindUserRecord(NetId);
+	if (Record != nullptr)
 	{
-		EOS_EpicAccountId AccountId = StringToAccountIdMap[EosId.UniqueNetIdStr];
-		if (AccountIdToUserNumMap.Contains(AccountId))
+		if (AccountIdToUserNumMap.Contains(Record->EpicAccountId))
 		{
-			return AccountIdToUserNumMap[AccountId];
+			return AccountIdToUserNumMap[Record->EpicAccountId];
 		}
 	}
 	// Use the default user if we can't find the person that they want
@@ -935,8 +944,7 @@ int32 FUserManagerEOS::GetLocalUserNumFromUniqueNetId(const FUniqueNetId& NetId)
 
 bool FUserManagerEOS::IsLocalUser(const FUniqueNetId& NetId) const
 {
-	const FUniqueNetIdEOS& EosId = FUniqueNetIdEOS::Cast(NetId);
-	return StringToAccountIdMap.Contains(EosId.UniqueNetIdStr);
+	return FindUserRecord(NetId) != nullptr;
 }
 
 FUniqueNetIdEOSPtr FUserManagerEOS::GetLocalUniqueNetIdEOS(int32 LocalUserNum) const
@@ -1015,22 +1023,20 @@ EOS_ProductUserId FUserManagerEOS::GetLocalProductUserId(EOS_EpicAccountId Accou
 
 EOS_EpicAccountId FUserManagerEOS::GetEpicAccountId(const FUniqueNetId& NetId) const
 {
-	const FUniqueNetIdEOS& EOSId = FUniqueNetIdEOS::Cast(NetId);
-
-	if (StringToAccountIdMap.Contains(EOSId.UniqueNetIdStr))
+	const FUserRecordEOS* Record = FindUserRecord(NetId);
+	if (Record != nullptr)
 	{
-		return StringToAccountIdMap[EOSId.UniqueNetIdStr];
+		return Record->EpicAccountId;
 	}
 	return nullptr;
 }
 
 EOS_ProductUserId FUserManagerEOS::GetProductUserId(const FUniqueNetId& NetId) const
 {
-	const FUniqueNetIdEOS& EOSId = FUniqueNetIdEOS::Cast(NetId);
-
-	if (StringToProductUserIdMap.Contains(EOSId.UniqueNetIdStr))
+	const FUserRecordEOS* Record = FindUserRecord(NetId);
+	if (Record != nullptr)
 	{
-		return StringToProductUserIdMap[EOSId.UniqueNetIdStr];
+		return Record->ProductUserId;
 	}
 	return nullptr;
 }
@@ -1072,40 +1078,83 @@ bool FUserManagerEOS::GetEpicAccountIdFromProductUserId(const EOS_ProductUserId&
 	return bResult;
 }
 
-void FUserManagerEOS::GetEpicAccountIdAsync(const EOS_ProductUserId& ProductUserId, const GetEpicAccountIdAsyncCallback& Callback) const
+void FUserManagerEOS::GetEpicAccountIdAsync(const EOS_ProductUserId& ProductUserId, const GetEpicAccountIdAsyncCallback& Callback)
 {
 	// We check first if the Product User Id has already been queried, which would allow us to retrieve its Epic Account Id directly
 	EOS_EpicAccountId AccountId;
 	if (GetEpicAccountIdFromProductUserId(ProductUserId, AccountId))
 	{
 		Callback(ProductUserId, AccountId);
+		return;
 	}
-	else
+
+	// Someone already asked the backend about this id, so share their answer
+	if (TArray<GetEpicAccountIdAsyncCallback>* InFlightCallbacks = InFlightEpicAccountIdQueries.Find(ProductUserId))
 	{
-		// If it's the first time we want the Epic Account Id for this Product User Id, we have to query it first
-		TArray<EOS_ProductUserId> ProductUserIdList = { const_cast<EOS_ProductUserId>(ProductUserId) };
+		InFlightCallbacks->Add(Callback);
+		return;
+	}
+
+	// Otherwise wait until next tick, so every id asked for this frame goes out in as few queries as possible
+	PendingEpicAccountIdQueries.FindOrAdd(ProductUserId).Add(Callback);
+	if (!bIsEpicAccountIdQueryScheduled)
+	{
+		bIsEpicAccountIdQueryScheduled = true;
+		EOSSubsystem->ExecuteNextTick([this]()
+			{
+				QueryPendingEpicAccountIds();
+			});
+	}
+}
+
+void FUserManagerEOS::QueryPendingEpicAccountIds()
+{
+	bIsEpicAccountIdQueryScheduled = false;
+
+	TArray<EOS_ProductUserId> ProductUserIds;
+	ProductUserIds.Reserve(PendingEpicAccountIdQueries.Num());
+	for (TPair<EOS_ProductUserId, TArray<GetEpicAccountIdAsyncCallback>>& Pending : PendingEpicAccountIdQueries)
+	{
+		ProductUserIds.Add(Pending.Key);
+		InFlightEpicAccountIdQueries.Add(Pending.Key, MoveTemp(Pending.Value));
+	}
+	PendingEpicAccountIdQueries.Reset();
+
+	for (int32 BatchStart = 0; BatchStart < ProductUserIds.Num(); BatchStart += EOS_OSS_MAX_PRODUCT_USER_ID_MAPPINGS_PER_QUERY)
+	{
+		const int32 BatchSize = FMath::Min(ProductUserIds.Num() - BatchStart, EOS_OSS_MAX_PRODUCT_USER_ID_MAPPINGS_PER_QUERY);
+		TArray<EOS_ProductUserId> BatchIds(ProductUserIds.GetData() + BatchStart, BatchSize);
 
 		EOS_Connect_QueryProductUserIdMappingsOptions QueryProductUserIdMappingsOptions = {};
 		QueryProductUserIdMappingsOptions.ApiVersion = EOS_CONNECT_QUERYPRODUCTUSERIDMAPPINGS_API_LATEST;
-		QueryProductUserIdMappingsOptions.LocalUserId = EOSSubsystem->UserManager->GetLocalProductUserId(0);
-		QueryProductUserIdMappingsOptions.ProductUserIds = ProductUserIdList.GetData();
-		QueryProductUserIdMappingsOptions.ProductUserIdCount = 1;
+		QueryProductUserIdMappingsOptions.LocalUserId = GetLocalProductUserId(0);
+		QueryProductUserIdMappingsOptions.ProductUserIds = BatchIds.GetData();
+		QueryProductUserIdMappingsOptions.ProductUserIdCount = BatchIds.Num();
 
 		FConnectQueryProductUserIdMappingsCallback* CallbackObj = new FConnectQueryProductUserIdMappingsCallback();
-		CallbackObj->CallbackLambda = [this, ProductUserId, Callback](const EOS_Connect_QueryProductUserIdMappingsCallbackInfo* Data)
+		CallbackObj->CallbackLambda = [this, BatchIds](const EOS_Connect_QueryProductUserIdMappingsCallbackInfo* Data)
 		{
-			if (Data->ResultCode == EOS_EResult::EOS_Success)
+			const bool bWasSuccessful = Data->ResultCode == EOS_EResult::EOS_Success;
+			if (!bWasSuccessful)
 			{
+				UE_LOG_ONLINE(Warning, TEXT("[FUserManagerEOS::QueryPendingEpicAccountIds] EOS_Connect_QueryProductUserIdMappings for %d ids not successful. Finished with EOS_EResult %s."), BatchIds.Num(), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+			}
+
+			for (EOS_ProductUserId ProductUserId : BatchIds)
+			{
+				// As before, callbacks only fire for ids that could be resolved
+				TArray<GetEpicAccountIdAsyncCallback> Callbacks;
+				InFlightEpicAccountIdQueries.RemoveAndCopyValue(ProductUserId, Callbacks);
+
 				EOS_EpicAccountId AccountId;
-				if (GetEpicAccountIdFromProductUserId(ProductUserId, AccountId))
+				if (bWasSuccessful && GetEpicAccountIdFromProductUserId(ProductUserId, AccountId))
 				{
-					Callback(ProductUserId, AccountId);
+					for (const GetEpicAccountIdAsyncCallback& Callback : Callbacks)
+					{
+						Callback(ProductUserId, AccountId);
+					}
 				}
 			}
-			else
-			{
-				UE_LOG_ONLINE(Warning, TEXT("[FUserManagerEOS::GetEpicAccountIdAsync] EOS_Connect_QueryProductUserIdMappings not successful. Finished with EOS_EResult %s."), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
-			}
 		};
 
 		EOS_Connect_QueryProductUserIdMappings(EOSSubsystem->ConnectHandle, &QueryProductUserIdMappingsOptions, CallbackObj, CallbackObj->GetCallbackPtr());
@@ -1117,10 +1166,10 @@ FOnlineUserPtr FUserManagerEOS::GetLocalOnlineUser(int32 LocalUserNum) const
 	FOnlineUserPtr OnlineUser;
 	if (UserNumToNetIdMap.Contains(LocalUserNum))
 	{
-		const FUniqueNetIdEOSPtr NetId = UserNumToNetIdMap.FindRef(LocalUserNum);
-		if (NetIdStringToOnlineUserMap.Contains(*NetId->UniqueNetIdStr))
+		const FUserRecordEOS* Record = FindUserRecord(*UserNumToNetIdMap.FindRef(LocalUserNum));
+		if (Record != nullptr)
 		{
-			OnlineUser = NetIdStringToOnlineUserMap.FindRef(*NetId->UniqueNetIdStr);
+			OnlineUser = Record->OnlineUser;
 		}
 	}
 	return OnlineUser;
@@ -1129,13 +1178,10 @@ FOnlineUserPtr FUserManagerEOS::GetLocalOnlineUser(int32 LocalUserNum) const
 FOnlineUserPtr FUserManagerEOS::GetOnlineUser(EOS_ProductUserId UserId) const
 {
 	FOnlineUserPtr OnlineUser;
-	if (ProductUserIdToStringMap.Contains(UserId))
+	const FUserRecordEOS* Record = FindUserRecord(UserId);
+	if (Record != nullptr)
 	{
-		const FString& NetId = ProductUserIdToStringMap.FindRef(UserId);
-		if (NetIdStringToOnlineUserMap.Contains(*NetId))
-		{
-			OnlineUser = NetIdStringToOnlineUserMap.FindRef(*NetId);
-		}
+		OnlineUser = Record->OnlineUser;
 	}
 	return OnlineUser;
 }
@@ -1143,15 +1189,123 @@ FOnlineUserPtr FUserManagerEOS::GetOnlineUser(EOS_ProductUserId UserId) const
 FOnlineUserPtr FUserManagerEOS::GetOnlineUser(EOS_EpicAccountId AccountId) const
 {
 	FOnlineUserPtr OnlineUser;
-	if (AccountIdToStringMap.Contains(AccountId))
+	const FUserRecordEOS* Record = FindUserRecord(AccountId);
+	if (Record != nullptr)
 	{
-		const FString& NetId = AccountIdToStringMap.FindRef(AccountId);
-		if (NetIdStringToOnlineUserMap.Contains(*NetId))
+		OnlineUser = Record->OnlineUser;
+	}
+	return OnlineUser;
+}
+
+FUserRecordEOS* FUserManagerEOS::FindUserRecord(const FUniqueNetId& NetId)
+{
+	return const_cast<FUserRecordEOS*>(static_cast<const FUserManagerEOS*>(this)->FindUserRecord(NetId));
+}
+
+const FUserRecordEOS* FUserManagerEOS::FindUserRecord(const FUniqueNetId& NetId) const
+{
+	const int32* FoundIndex = NetIdKeyToUserRecordMap.Find(FUniqueNetIdKeyEOS(FUniqueNetIdEOS::Cast(NetId)));
+	return FoundIndex != nullptr ? &UserRecords[*FoundIndex] : nullptr;
+}
+
+FUserRecordEOS* FUserManagerEOS::FindUserRecord(EOS_EpicAccountId AccountId)
+{
+	return const_cast<FUserRecordEOS*>(static_cast<const FUserManagerEOS*>(this)->FindUserRecord(AccountId));
+}
+
+const FUserRecordEOS* FUserManagerEOS::FindUserRecord(EOS_EpicAccountId AccountId) const
+{
+	const int32* FoundIndex = AccountIdToUserRecordMap.Find(AccountId);
+	return FoundIndex != nullptr ? &UserRecords[*FoundIndex] : nullptr;
+}
+
+const FUserRecordEOS* FUserManagerEOS::FindUserRecord(EOS_ProductUserId UserId) const
+{
+	const int32* FoundIndex = ProductUserIdToUserRecordMap.Find(UserId);
+	return FoundIndex != nullptr ? &UserRecords[*FoundIndex] : nullptr;
+}
+
+FUserRecordEOS& FUserManagerEOS::FindOrAddUserRecord(const FUniqueNetIdKeyEOS& NetIdKey, EOS_EpicAccountId AccountId, EOS_ProductUserId UserId)
+{
+	int32 Index = INDEX_NONE;
+	const int32* FoundIndex = NetIdKeyToUserRecordMap.Find(NetIdKey);
+	if (FoundIndex != nullptr)
+	{
+		Index = *FoundIndex;
+	}
+	else
+	{
+		Index = UserRecords.Add(FUserRecordEOS());
+		UserRecords[Index].NetIdKey = NetIdKey;
+		NetIdKeyToUserRecordMap.Add(NetIdKey, Index);
+	}
+
+	FUserRecordEOS& Record = UserRecords[Index];
+	if (AccountId != nullptr)
+	{
+		Record.EpicAccountId = AccountId;
+		AccountIdToUserRecordMap.Add(AccountId, Index);
+	}
+	if (UserId != nullptr)
+	{
+		Record.ProductUserId = UserId;
+		ProductUserIdToUserRecordMap.Add(UserId, Index);
+	}
+	return Record;
+}
+
+void FUserManagerEOS::RekeyUserRecord(FUserRecordEOS& Record, const FUniqueNetIdKeyEOS& NewNetIdKey)
+{
+	if (Record.NetIdKey == NewNetIdKey)
+	{
+		return;
+	}
+
+	const int32 Index = NetIdKeyToUserRecordMap.FindAndRemoveChecked(Record.NetIdKey);
+	// Anyone already using the new key is replaced, but a local user keeps their account
+	const int32* ExistingIndex = NetIdKeyToUserRecordMap.Find(NewNetIdKey);
+	if (ExistingIndex != nullptr)
+	{
+		if (!Record.UserAccount.IsValid())
 		{
-			OnlineUser = NetIdStringToOnlineUserMap.FindRef(*NetId);
+			Record.UserAccount = UserRecords[*ExistingIndex].UserAccount;
 		}
+		RemoveUserRecord(NewNetIdKey);
+	}
+
+	Record.NetIdKey = NewNetIdKey;
+	NetIdKeyToUserRecordMap.Add(NewNetIdKey, Index);
+	if (Record.EpicAccountId != nullptr)
+	{
+		AccountIdToUserRecordMap.Add(Record.EpicAccountId, Index);
+	}
+	if (Record.ProductUserId != nullptr)
+	{
+		ProductUserIdToUserRecordMap.Add(Record.ProductUserId, Index);
 	}
-	return OnlineUser;
+}
+
+void FUserManagerEOS::RemoveUserRecord(const FUniqueNetIdKeyEOS& NetIdKey)
+{
+	int32 Index = INDEX_NONE;
+	if (!NetIdKeyToUserRecordMap.RemoveAndCopyValue(NetIdKey, Index))
+	{
+		return;
+	}
+
+	// The id indices may have moved on to a newer record for the same account
+	const FUserRecordEOS& Record = UserRecords[Index];
+	const int32* AccountIdIndex = AccountIdToUserRecordMap.Find(Record.EpicAccountId);
+	if (AccountIdIndex != nullptr && *AccountIdIndex == Index)
+	{
+		AccountIdToUserRecordMap.Remove(Record.EpicAccountId);
+	}
+	const int32* UserIdIndex = ProductUserIdToUserRecordMap.Find(Record.ProductUserId);
+	if (UserIdIndex != nullptr && *UserIdIndex == Index)
+	{
+		ProductUserIdToUserRecordMap.Remove(Record.ProductUserId);
+	}
+	UserRecords.RemoveAt(Index);
 }
 
 void FUserManagerEOS::RemoveLocalUser(int32 LocalUserNum)
@@ -1161,24 +1315,25 @@ void FUserManagerEOS::RemoveLocalUser(int32 LocalUserNum)
 	{
 		EOSSubsystem->ReleaseVoiceChatUserInterface(**FoundId);
 		LocalUserNumToFriendsListMap.Remove(LocalUserNum);
-		const FString& NetId = (*FoundId)->UniqueNetIdStr;
-		EOS_EpicAccountId AccountId = StringToAccountIdMap[NetId];
-		AccountIdToStringMap.Remove(AccountId);
-		AccountIdToUserNumMap.Remove(AccountId);
-		NetIdStringToOnlineUserMap.Remove(NetId);
-		StringToAccountIdMap.Remove(NetId);
-		StringToUserAccountMap.Remove(NetId);
+		PendingFriendsListDeltaMap.Remove(LocalUserNum);
+		DiscardPresencePublishes(UserNumToAccountIdMap[LocalUserNum]);
+		AccountIdToUserNumMap.Remove(UserNumToAccountIdMap[LocalUserNum]);
+		RemoveUserRecord(FUniqueNetIdKeyEOS(**FoundId));
 		UserNumToNetIdMap.Remove(LocalUserNum);
 		UserNumToAccountIdMap.Remove(LocalUserNum);
 		EOS_ProductUserId UserId = UserNumToProductUserIdMap[LocalUserNum];
 		ProductUserIdToUserNumMap.Remove(UserId);
-		ProductUserIdToStringMap.Remove(UserId);
 		UserNumToProductUserIdMap.Remove(LocalUserNum);
 	}
 	// Reset this for the next user login
 	if (LocalUserNum == DefaultLocalUser)
 	{
 		DefaultLocalUser = -1;
+		// User info is read on behalf of the default user, so what we cached went with them
+		if (UserInfoCacheTTL > 0.0)
+		{
+			UserInfoReadTimes.Empty(UEOSSettings::GetSettings().UserInfoCacheMaxEntries);
+		}
 	}
 }
 
@@ -1210,12 +1365,7 @@ ELoginStatus::Type FUserManagerEOS::GetLoginStatus(int32 LocalUserNum) const
 
 ELoginStatus::Type FUserManagerEOS::GetLoginStatus(const FUniqueNetIdEOS& UserId) const
 {
-	if (!StringToAccountIdMap.Contains(UserId.UniqueNetIdStr))
-	{
-		return ELoginStatus::NotLoggedIn;
-	}
-
-	EOS_EpicAccountId AccountId = StringToAccountIdMap[UserId.UniqueNetIdStr];
+	EOS_EpicAccountId AccountId = GetEpicAccountId(UserId);
 	if (AccountId == nullptr)
 	{
 		return ELoginStatus::NotLoggedIn;
@@ -1451,13 +1601,15 @@ void FUserManagerEOS::FriendStatusChanged(const EOS_Friends_OnFriendsUpdateInfo*
 		int32 LocalUserNum = AccountIdToUserNumMap[Data->LocalUserId];
 		FUniqueNetIdEOSPtr LocalEOSID = UserNumToNetIdMap[LocalUserNum];
 		// If we don't know them yet, then add them to kick off the reads
-		if (!AccountIdToStringMap.Contains(Data->TargetUserId))
+		if (FindUserRecord(Data->TargetUserId) == nullptr)
 		{
 			AddFriend(LocalUserNum, Data->TargetUserId);
 		}
 		// They are in our list now
-		FOnlineUserPtr OnlineUser = EpicAccountIdToOnlineUserMap[Data->TargetUserId];
-		FOnlineFriendEOSPtr Friend = LocalUserNumToFriendsListMap[LocalUserNum]->GetByNetIdString(AccountIdToStringMap[Data->TargetUserId]);
+		const FUserRecordEOS* Record = FindUserRecord(Data->TargetUserId);
+		FOnlineUserPtr OnlineUser = Record->OnlineUser;
+		const FUniqueNetIdKeyEOS FriendKey = Record->NetIdKey;
+		FOnlineFriendEOSPtr Friend = LocalUserNumToFriendsListMap[LocalUserNum]->GetByNetIdKey(FriendKey);
 		// Figure out which notification to fire
 		if (Data->CurrentStatus == EOS_EFriendsStatus::EOS_FS_Friends)
 		{
@@ -1466,13 +1618,13 @@ void FUserManagerEOS::FriendStatusChanged(const EOS_Friends_OnFriendsUpdateInfo*
 		}
 		else if (Data->PreviousStatus == EOS_EFriendsStatus::EOS_FS_Friends && Data->CurrentStatus == EOS_EFriendsStatus::EOS_FS_NotFriends)
 		{
-			LocalUserNumToFriendsListMap[LocalUserNum]->Remove(AccountIdToStringMap[Data->TargetUserId], Friend.ToSharedRef());
+			LocalUserNumToFriendsListMap[LocalUserNum]->Remove(FriendKey, Friend.ToSharedRef());
 			Friend->SetInviteStatus(EInviteStatus::Unknown);
 			TriggerOnFriendRemovedDelegates(*LocalEOSID, *OnlineUser->GetUserId());
 		}
 		else if (Data->PreviousStatus < EOS_EFriendsStatus::EOS_FS_Friends && Data->CurrentStatus == EOS_EFriendsStatus::EOS_FS_NotFriends)
 		{
-			LocalUserNumToFriendsListMap[LocalUserNum]->Remove(AccountIdToStringMap[Data->TargetUserId], Friend.ToSharedRef());
+			LocalUserNumToFriendsListMap[LocalUserNum]->Remove(FriendKey, Friend.ToSharedRef());
 			Friend->SetInviteStatus(EInviteStatus::Unknown);
 			TriggerOnInviteRejectedDelegates(*LocalEOSID, *OnlineUser->GetUserId());
 		}
@@ -1485,12 +1637,12 @@ void FUserManagerEOS::FriendStatusChanged(const EOS_Friends_OnFriendsUpdateInfo*
 	}
 }
 
-void FUserManagerEOS::AddFriend(int32 LocalUserNum, EOS_EpicAccountId EpicAccountId)
+FOnlineFriendEOSRef FUserManagerEOS::AddFriend(int32 LocalUserNum, EOS_EpicAccountId EpicAccountId)
 {
 	const FString NetId = LexToString(EpicAccountId);
 	FUniqueNetIdEOSRef FriendNetId = FUniqueNetIdEOS::Create(NetId);
 	FOnlineFriendEOSRef FriendRef = MakeShareable(new FOnlineFriendEOS(FriendNetId));
-	LocalUserNumToFriendsListMap[LocalUserNum]->Add(NetId, FriendRef);
+	LocalUserNumToFriendsListMap[LocalUserNum]->Add(FUniqueNetIdKeyEOS(*FriendNetId), FriendRef);
 
 	EOS_Friends_GetStatusOptions Options = { };
 	Options.ApiVersion = EOS_FRIENDS_GETSTATUS_API_LATEST;
@@ -1502,6 +1654,7 @@ void FUserManagerEOS::AddFriend(int32 LocalUserNum, EOS_EpicAccountId EpicAccoun
 
 	// Add this friend as a remote (this will grab presence & user info)
 	AddRemotePlayer(LocalUserNum, NetId, EpicAccountId, FriendNetId, FriendRef, FriendRef);
+	return FriendRef;
 }
 
 void FUserManagerEOS::AddRemotePlayer(int32 LocalUserNum, const FString& NetId, EOS_EpicAccountId EpicAccountId)
@@ -1514,13 +1667,9 @@ void FUserManagerEOS::AddRemotePlayer(int32 LocalUserNum, const FString& NetId,
 
 void FUserManagerEOS::AddRemotePlayer(int32 LocalUserNum, const FString& NetId, EOS_EpicAccountId EpicAccountId, FUniqueNetIdEOSPtr UniqueNetId, FOnlineUserPtr OnlineUser, IAttributeAccessInterfaceRef AttributeRef)
 {
-	NetIdStringToOnlineUserMap.Emplace(NetId, OnlineUser);
-	EpicAccountIdToOnlineUserMap.Emplace(EpicAccountId, OnlineUser);
-	NetIdStringToAttributeAccessMap.Emplace(NetId, AttributeRef);
-	EpicAccountIdToAttributeAccessMap.Emplace(EpicAccountId, AttributeRef);
-
-	StringToAccountIdMap.Emplace(NetId, EpicAccountId);
-	AccountIdToStringMap.Emplace(EpicAccountId, NetId);
+	FUserRecordEOS& Record = FindOrAddUserRecord(FUniqueNetIdKeyEOS(*UniqueNetId), EpicAccountId, nullptr);
+	Record.OnlineUser = OnlineUser;
+	Record.AttributeAccess = AttributeRef;
 
 	// Read the user info for this player
 	ReadUserInfo(LocalUserNum, EpicAccountId);
@@ -1539,63 +1688,34 @@ void FUserManagerEOS::AddRemotePlayer(int32 LocalUserNum, const FString& NetId,
 void FUserManagerEOS::UpdateRemotePlayerProductUserId(EOS_EpicAccountId AccountId, EOS_ProductUserId UserId)
 {
 	// See if the net ids have changed for this user and bail if they are the same
-	const FString NewNetIdStr = MakeNetIdStringFromIds(AccountId, UserId);
-	const FString PrevNetIdStr = AccountIdToStringMap[AccountId];
-	if (PrevNetIdStr == NewNetIdStr)
+	const FUniqueNetIdKeyEOS NewNetIdKey(AccountId, UserId);
+	FUserRecordEOS* Record = FindUserRecord(AccountId);
+	if (Record == nullptr || Record->NetIdKey == NewNetIdKey)
 	{
 		// No change, so skip any work
 		return;
 	}
-
-	const FString AccountIdStr = LexToString(AccountId);
-	const FString UserIdStr = LexToString(UserId);
+	const FUniqueNetIdKeyEOS PrevNetIdKey = Record->NetIdKey;
 
 	// Get the unique net id and rebuild the string for it
-	IAttributeAccessInterfaceRef AttrAccess = NetIdStringToAttributeAccessMap[PrevNetIdStr];
-	FUniqueNetIdEOSPtr NetIdEOS = AttrAccess->GetUniqueNetIdEOS();
+	FUniqueNetIdEOSPtr NetIdEOS = Record->AttributeAccess.IsValid() ? Record->AttributeAccess->GetUniqueNetIdEOS() : FUniqueNetIdEOSPtr();
 	if (NetIdEOS.IsValid())
 	{
-		ConstCastSharedPtr<FUniqueNetIdEOS>(NetIdEOS)->UpdateNetIdStr(NewNetIdStr);
+		ConstCastSharedPtr<FUniqueNetIdEOS>(NetIdEOS)->UpdateNetIdStr(MakeNetIdStringFromIds(AccountId, UserId));
 	}
 	// Update any old friends entries with the new net id key
 	for (TMap<int32, FFriendsListEOSRef>::TConstIterator It(LocalUserNumToFriendsListMap); It; ++It)
 	{
 		FFriendsListEOSRef FriendsList = It.Value();
-		FOnlineFriendEOSPtr FoundFriend = FriendsList->GetByNetIdString(PrevNetIdStr);
+		FOnlineFriendEOSPtr FoundFriend = FriendsList->GetByNetIdKey(PrevNetIdKey);
 		if (FoundFriend.IsValid())
 		{
-			FriendsList->UpdateNetIdStr(PrevNetIdStr, NewNetIdStr);
+			FriendsList->UpdateNetIdKey(PrevNetIdKey, NewNetIdKey);
 		}
 	}
-	// Update all of the other net id to X mappings
-	AccountIdToStringMap.Remove(AccountId);
-	AccountIdToStringMap.Emplace(AccountId, NewNetIdStr);
-	ProductUserIdToStringMap.Remove(UserId);
-	ProductUserIdToStringMap.Emplace(UserId, *NewNetIdStr);
-	StringToAccountIdMap.Remove(PrevNetIdStr);
-	StringToAccountIdMap.Emplace(NewNetIdStr, AccountId);
-	StringToProductUserIdMap.Emplace(NewNetIdStr, UserId);
-	// If it's the first time we're updating this remote player, it will be indexed by its epic account id
-	FOnlineUserPtr OnlineUser = NetIdStringToOnlineUserMap[AccountIdStr];
-	if (OnlineUser.IsValid())
-	{
-		NetIdStringToOnlineUserMap.Remove(AccountIdStr);
-	}
-	else
-	{
-		OnlineUser = NetIdStringToOnlineUserMap[PrevNetIdStr];
-		NetIdStringToOnlineUserMap.Remove(PrevNetIdStr);
-	}
-	NetIdStringToOnlineUserMap.Emplace(NewNetIdStr, OnlineUser);
-	NetIdStringToAttributeAccessMap.Remove(PrevNetIdStr);
-	NetIdStringToAttributeAccessMap.Emplace(NewNetIdStr, AttrAccess);
-	// Presence may not be available for all online users
-	if (NetIdStringToOnlineUserPresenceMap.Contains(PrevNetIdStr))
-	{
-		FOnlineUserPresenceRef UserPresence = NetIdStringToOnlineUserPresenceMap[PrevNetIdStr];
-		NetIdStringToOnlineUserPresenceMap.Remove(PrevNetIdStr);
-		NetIdStringToOnlineUserPresenceMap.Emplace(NewNetIdStr, UserPresence);
-	}
+	// The online user, attributes and presence all move with the record
+	Record->ProductUserId = UserId;
+	RekeyUserRecord(*Record, NewNetIdKey);
 }
 
 // IOnlineFriends Interface
@@ -1642,26 +1762,7 @@ bool FUserManagerEOS::ReadFriendsList(int32 LocalUserNum, const FString& ListNam
 		bool bWasSuccessful = Result == EOS_EResult::EOS_Success;
 		if (bWasSuccessful)
 		{
-			EOS_Friends_GetFriendsCountOptions Options = { };
-			Options.ApiVersion = EOS_FRIENDS_GETFRIENDSCOUNT_API_LATEST;
-			Options.LocalUserId = UserNumToAccountIdMap[LocalUserNum];
-			int32 FriendCount = EOS_Friends_GetFriendsCount(EOSSubsystem->FriendsHandle, &Options);
-
-			LocalUserNumToFriendsListMap[LocalUserNum]->Empty();
-
-			// Process each friend returned
-			for (int32 Index = 0; Index < FriendCount; Index++)
-			{
-				EOS_Friends_GetFriendAtIndexOptions FriendIndexOptions = { };
-				FriendIndexOptions.ApiVersion = EOS_FRIENDS_GETFRIENDATINDEX_API_LATEST;
-				FriendIndexOptions.Index = Index;
-				FriendIndexOptions.LocalUserId = Options.LocalUserId;
-				EOS_EpicAccountId FriendEpicAccountId = EOS_Friends_GetFriendAtIndex(EOSSubsystem->FriendsHandle, &FriendIndexOptions);
-				if (FriendEpicAccountId != nullptr)
-				{
-					AddFriend(LocalUserNum, FriendEpicAccountId);
-				}
-			}
+			RefreshFriendsList(LocalUserNum);
 		}
 		else
 		{
@@ -1676,6 +1777,77 @@ bool FUserManagerEOS::ReadFriendsList(int32 LocalUserNum, const FString& ListNam
 	return true;
 }
 
+void FUserManagerEOS::RefreshFriendsList(int32 LocalUserNum)
+{
+	FFriendsListEOSRef FriendsList = LocalUserNumToFriendsListMap[LocalUserNum];
+	FFriendsListDeltaEOS& Delta = PendingFriendsListDeltaMap.FindOrAdd(LocalUserNum);
+
+	EOS_Friends_GetFriendsCountOptions Options = { };
+	Options.ApiVersion = EOS_FRIENDS_GETFRIENDSCOUNT_API_LATEST;
+	Options.LocalUserId = UserNumToAccountIdMap[LocalUserNum];
+	int32 FriendCount = EOS_Friends_GetFriendsCount(EOSSubsystem->FriendsHandle, &Options);
+
+	// Diff against the keys the list stored, by their Epic account half, since the SDK only gives us account ids
+	// and a friend's product user id may or may not have resolved yet
+	TMap<FUniqueNetIdKeyEOS, FUniqueNetIdKeyEOS> StoredKeysByAccountId;
+	StoredKeysByAccountId.Reserve(FriendsList->GetNetIdKeyMap().Num());
+	for (const TPair<FUniqueNetIdKeyEOS, FOnlineFriendEOSRef>& Entry : FriendsList->GetNetIdKeyMap())
+	{
+		StoredKeysByAccountId.Add(Entry.Key.GetEpicAccountIdKey(), Entry.Key);
+	}
+
+	// Process each friend returned, keeping the ones we already have along with their presence and user info
+	TSet<FUniqueNetIdKeyEOS> CurrentAccountIds;
+	CurrentAccountIds.Reserve(FriendCount);
+	for (int32 Index = 0; Index < FriendCount; Index++)
+	{
+		EOS_Friends_GetFriendAtIndexOptions FriendIndexOptions = { };
+		FriendIndexOptions.ApiVersion = EOS_FRIENDS_GETFRIENDATINDEX_API_LATEST;
+		FriendIndexOptions.Index = Index;
+		FriendIndexOptions.LocalUserId = Options.LocalUserId;
+		EOS_EpicAccountId FriendEpicAccountId = EOS_Friends_GetFriendAtIndex(EOSSubsystem->FriendsHandle, &FriendIndexOptions);
+		if (FriendEpicAccountId == nullptr)
+		{
+			continue;
+		}
+
+		const FUniqueNetIdKeyEOS AccountIdKey(FriendEpicAccountId, nullptr);
+		CurrentAccountIds.Add(AccountIdKey);
+
+		const FUniqueNetIdKeyEOS* StoredKey = StoredKeysByAccountId.Find(AccountIdKey);
+		FOnlineFriendEOSPtr Friend = StoredKey != nullptr ? FriendsList->GetByNetIdKey(*StoredKey) : FOnlineFriendEOSPtr();
+		if (Friend.IsValid())
+		{
+			// The status comes from the SDK's local cache, so refreshing it doesn't cost a request
+			EOS_Friends_GetStatusOptions StatusOptions = { };
+			StatusOptions.ApiVersion = EOS_FRIENDS_GETSTATUS_API_LATEST;
+			StatusOptions.LocalUserId = Options.LocalUserId;
+			StatusOptions.TargetUserId = FriendEpicAccountId;
+			Friend->SetInviteStatus(ToEInviteStatus(EOS_Friends_GetStatus(EOSSubsystem->FriendsHandle, &StatusOptions)));
+		}
+		else
+		{
+			FOnlineFriendEOSRef NewFriend = AddFriend(LocalUserNum, FriendEpicAccountId);
+			Delta.Added.Add(NewFriend->GetUserId());
+		}
+	}
+
+	// Anyone we didn't see is no longer a friend
+	TArray<TPair<FUniqueNetIdKeyEOS, FOnlineFriendEOSRef>> RemovedFriends;
+	for (const TPair<FUniqueNetIdKeyEOS, FOnlineFriendEOSRef>& Entry : FriendsList->GetNetIdKeyMap())
+	{
+		if (!CurrentAccountIds.Contains(Entry.Key.GetEpicAccountIdKey()))
+		{
+			RemovedFriends.Emplace(Entry.Key, Entry.Value);
+		}
+	}
+	for (const TPair<FUniqueNetIdKeyEOS, FOnlineFriendEOSRef>& Entry : RemovedFriends)
+	{
+		FriendsList->Remove(Entry.Key, Entry.Value);
+		Delta.Removed.Add(Entry.Value->GetUserId());
+	}
+}
+
 void FUserManagerEOS::ProcessReadFriendsListComplete(int32 LocalUserNum, bool bWasSuccessful, const FString& ErrorStr)
 {
 	// If we started any user info queries for friends, we'll just wait until they finish
@@ -1693,7 +1865,13 @@ void FUserManagerEOS::ProcessReadFriendsListComplete(int32 LocalUserNum, bool bW
 			CachedReadUserListInfoForLocalUserMap.Remove(LocalUserNum);
 		}
 
-		IsFriendQueryUserInfoOngoingForLocalUserMap.Remove(LocalUserNum);
+		FFriendsListDeltaEOS Delta;
+		if (PendingFriendsListDeltaMap.RemoveAndCopyValue(LocalUserNum, Delta))
+		{
+			TriggerOnFriendsListDeltaDelegates(LocalUserNum, Delta.Added, Delta.Removed);
+		}
+
+		NumUserInfoReadsOngoingForLocalUserMap.Remove(LocalUserNum);
 	}
 }
 
@@ -1740,8 +1918,8 @@ bool FUserManagerEOS::SendInvite(int32 LocalUserNum, const FUniqueNetId& FriendI
 		return false;
 	}
 
-	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(FriendId);
-	if (!StringToAccountIdMap.Contains(EOSID.UniqueNetIdStr))
+	const EOS_EpicAccountId FriendAccountId = GetEpicAccountId(FriendId);
+	if (FriendAccountId == nullptr)
 	{
 		UE_LOG_ONLINE_FRIEND(Warning, TEXT("Can't SendInvite() for user (%d) since the potential player id is unknown"), LocalUserNum);
 		Delegate.ExecuteIfBound(LocalUserNum, false, FriendId, ListName, FString(TEXT("Can't SendInvite() for user (%d) since the player id is unknown"), LocalUserNum));
@@ -1751,7 +1929,9 @@ bool FUserManagerEOS::SendInvite(int32 LocalUserNum, const FUniqueNetId& FriendI
 	FSendInviteCallback* CallbackObj = new FSendInviteCallback();
 	CallbackObj->CallbackLambda = [LocalUserNum, ListName, this, Delegate](const EOS_Friends_SendInviteCallbackInfo* Data)
 	{
-		const FString& NetId = AccountIdToStringMap[Data->TargetUserId];
+		const FUserRecordEOS* Record = FindUserRecord(Data->TargetUserId);
+		const FUniqueNetIdRef FriendNetId = Record != nullptr ? Record->OnlineUser->GetUserId() : FUniqueNetIdRef(FUniqueNetIdEOS::EmptyId());
+		const FString NetId = FriendNetId->ToString();
 
 		FString ErrorString;
 		bool bWasSuccessful = Data->ResultCode == EOS_EResult::EOS_Success;
@@ -1759,13 +1939,13 @@ bool FUserManagerEOS::SendInvite(int32 LocalUserNum, const FUniqueNetId& FriendI
 		{
 			ErrorString = FString::Printf(TEXT("Failed to send invite for user (%d) to player (%s) with result code (%s)"), LocalUserNum, *NetId, ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
 		}
-		Delegate.ExecuteIfBound(LocalUserNum, bWasSuccessful, *FUniqueNetIdEOS::Create(NetId), ListName, ErrorString);
+		Delegate.ExecuteIfBound(LocalUserNum, bWasSuccessful, *FriendNetId, ListName, ErrorString);
 	};
 
 	EOS_Friends_SendInviteOptions Options = { };
 	Options.ApiVersion = EOS_FRIENDS_SENDINVITE_API_LATEST;
 	Options.LocalUserId = UserNumToAccountIdMap[LocalUserNum];
-	Options.TargetUserId = StringToAccountIdMap[EOSID.UniqueNetIdStr];
+	Options.TargetUserId = FriendAccountId;
 	EOS_Friends_SendInvite(EOSSubsystem->FriendsHandle, &Options, CallbackObj, CallbackObj->GetCallbackPtr());
 
 	return true;
@@ -1782,8 +1962,8 @@ bool FUserManagerEOS::AcceptInvite(int32 LocalUserNum, const FUniqueNetId& Frien
 		return false;
 	}
 
-	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(FriendId);
-	if (!StringToAccountIdMap.Contains(EOSID.UniqueNetIdStr))
+	const EOS_EpicAccountId FriendAccountId = GetEpicAccountId(FriendId);
+	if (FriendAccountId == nullptr)
 	{
 		UE_LOG_ONLINE_FRIEND(Warning, TEXT("Can't AcceptInvite() for user (%d) since the friend is not in their list"), LocalUserNum);
 		Delegate.ExecuteIfBound(LocalUserNum, false, FriendId, ListName, FString(TEXT("Can't AcceptInvite() for user (%d) since the friend is not in their list"), LocalUserNum));
@@ -1793,7 +1973,9 @@ bool FUserManagerEOS::AcceptInvite(int32 LocalUserNum, const FUniqueNetId& Frien
 	FAcceptInviteCallback* CallbackObj = new FAcceptInviteCallback();
 	CallbackObj->CallbackLambda = [LocalUserNum, ListName, this, Delegate](const EOS_Friends_AcceptInviteCallbackInfo* Data)
 	{
-		const FString& NetId = AccountIdToStringMap[Data->TargetUserId];
+		const FUserRecordEOS* Record = FindUserRecord(Data->TargetUserId);
+		const FUniqueNetIdRef FriendNetId = Record != nullptr ? Record->OnlineUser->GetUserId() : FUniqueNetIdRef(FUniqueNetIdEOS::EmptyId());
+		const FString NetId = FriendNetId->ToString();
 
 		FString ErrorString;
 		bool bWasSuccessful = Data->ResultCode == EOS_EResult::EOS_Success;
@@ -1801,13 +1983,13 @@ bool FUserManagerEOS::AcceptInvite(int32 LocalUserNum, const FUniqueNetId& Frien
 		{
 			ErrorString = FString::Printf(TEXT("Failed to accept invite for user (%d) from friend (%s) with result code (%s)"), LocalUserNum, *NetId, ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
 		}
-		Delegate.ExecuteIfBound(LocalUserNum, bWasSuccessful, *FUniqueNetIdEOS::Create(NetId), ListName, ErrorString);
+		Delegate.ExecuteIfBound(LocalUserNum, bWasSuccessful, *FriendNetId, ListName, ErrorString);
 	};
 
 	EOS_Friends_AcceptInviteOptions Options = { };
 	Options.ApiVersion = EOS_FRIENDS_ACCEPTINVITE_API_LATEST;
 	Options.LocalUserId = UserNumToAccountIdMap[LocalUserNum];
-	Options.TargetUserId = StringToAccountIdMap[EOSID.UniqueNetIdStr];
+	Options.TargetUserId = FriendAccountId;
 	EOS_Friends_AcceptInvite(EOSSubsystem->FriendsHandle, &Options, CallbackObj, CallbackObj->GetCallbackPtr());
 	return true;
 }
@@ -1825,8 +2007,8 @@ bool FUserManagerEOS::RejectInvite(int32 LocalUserNum, const FUniqueNetId& Frien
 		return false;
 	}
 
-	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(FriendId);
-	if (!StringToAccountIdMap.Contains(EOSID.UniqueNetIdStr))
+	const EOS_EpicAccountId FriendAccountId = GetEpicAccountId(FriendId);
+	if (FriendAccountId == nullptr)
 	{
 		UE_LOG_ONLINE_FRIEND(Warning, TEXT("Can't RejectInvite() for user (%d) since the friend is not in their list"), LocalUserNum);
 		return false;
@@ -1835,7 +2017,7 @@ bool FUserManagerEOS::RejectInvite(int32 LocalUserNum, const FUniqueNetId& Frien
 	EOS_Friends_RejectInviteOptions Options{ 0 };
 	Options.ApiVersion = EOS_FRIENDS_REJECTINVITE_API_LATEST;
 	Options.LocalUserId = UserNumToAccountIdMap[LocalUserNum];
-	Options.TargetUserId = StringToAccountIdMap[EOSID.UniqueNetIdStr];
+	Options.TargetUserId = FriendAccountId;
 	EOS_Friends_RejectInvite(EOSSubsystem->FriendsHandle, &Options, nullptr, &EOSRejectInviteCallback);
 	return true;
 }
@@ -1913,7 +2095,7 @@ TSharedPtr<FOnlineFriend> FUserManagerEOS::GetFriend(int32 LocalUserNum, const F
 	{
 		FFriendsListEOSRef FriendsList = LocalUserNumToFriendsListMap[LocalUserNum];
 		const FUniqueNetIdEOS& EosId = FUniqueNetIdEOS::Cast(FriendId);
-		FOnlineFriendEOSPtr FoundFriend = FriendsList->GetByNetIdString(EosId.UniqueNetIdStr);
+		FOnlineFriendEOSPtr FoundFriend = FriendsList->GetByNetIdKey(FUniqueNetIdKeyEOS(EosId));
 		if (FoundFriend.IsValid())
 		{
 			const FOnlineUserPresence& Presence = FoundFriend->GetPresence();
@@ -2126,23 +2308,96 @@ struct FRichTextOptions :
 
 typedef TEOSCallback<EOS_Presence_SetPresenceCompleteCallback, EOS_Presence_SetPresenceCallbackInfo> FSetPresenceCallback;
 
+/** Whether two statuses would put the same presence on the backend */
+static bool IsSamePresenceStatus(const FOnlineUserPresenceStatus& A, const FOnlineUserPresenceStatus& B)
+{
+	return A.State == B.State && A.StatusStr == B.StatusStr && A.Properties.OrderIndependentCompareEqual(B.Properties);
+}
+
 void FUserManagerEOS::SetPresence(const FUniqueNetId& UserId, const FOnlineUserPresenceStatus& Status, const FOnPresenceTaskCompleteDelegate& Delegate)
 {
 	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(UserId);
-	if (!StringToAccountIdMap.Contains(EOSID.UniqueNetIdStr))
+	const FUserRecordEOS* UserRecord = FindUserRecord(EOSID);
+	if (UserRecord == nullptr)
 	{
 		UE_LOG_ONLINE(Error, TEXT("Can't SetPresence() for user (%s) since they are not logged in"), *EOSID.UniqueNetIdStr);
 		return;
 	}
+	const EOS_EpicAccountId LocalAccountId = UserRecord->EpicAccountId;
+	FPresencePublishStateEOS& PublishState = PresencePublishStates.FindOrAdd(LocalAccountId);
+
+	// Nothing queued and this is what was last sent, so there's nothing to write
+	if (!PublishState.bHasPending && PublishState.bHasPublished && IsSamePresenceStatus(Status, PublishState.PublishedStatus))
+	{
+		if (PublishState.bInFlight)
+		{
+			// The write in flight carries this status, so it completes this call too
+			PublishState.InFlightDelegates.Add(Delegate);
+		}
+		else
+		{
+			EOSSubsystem->ExecuteNextTick([UserId = UserId.AsShared(), Delegate]()
+				{
+					Delegate.ExecuteIfBound(*UserId, true);
+				});
+		}
+		return;
+	}
+
+	// The latest status wins, every caller is completed by the write that carries it
+	PublishState.PendingStatus = Status;
+	PublishState.bHasPending = true;
+	PublishState.QueuedDelegates.Add(Delegate);
+
+	// Otherwise it goes out from TickPresencePublishes once the write in flight is done and the interval has passed
+	if (!PublishState.bInFlight && FPlatformTime::Seconds() - PublishState.LastSendTime >= SetPresenceMinInterval)
+	{
+		DispatchPresence(LocalAccountId, PublishState);
+	}
+}
+
+void FUserManagerEOS::DispatchPresence(EOS_EpicAccountId LocalAccountId, FPresencePublishStateEOS& PublishState)
+{
+	const FOnlineUserPresenceStatus& Status = PublishState.PendingStatus;
+
+	// Changes that were undone before they went out leave nothing to write
+	if (PublishState.bHasPublished && IsSamePresenceStatus(Status, PublishState.PublishedStatus))
+	{
+		TArray<FOnPresenceTaskCompleteDelegate> Delegates = MoveTemp(PublishState.QueuedDelegates);
+		PublishState.bHasPending = false;
+		FUniqueNetIdRef UserId = FUniqueNetIdEOS::EmptyId();
+		const FUserRecordEOS* UserRecord = FindUserRecord(LocalAccountId);
+		if (UserRecord != nullptr && UserRecord->OnlineUser.IsValid())
+		{
+			UserId = UserRecord->OnlineUser->GetUserId();
+		}
+		EOSSubsystem->ExecuteNextTick([UserId, Delegates]()
+			{
+				for (const FOnPresenceTaskCompleteDelegate& Delegate : Delegates)
+				{
+					Delegate.ExecuteIfBound(*UserId, true);
+				}
+			});
+		return;
+	}
 
 	EOS_HPresenceModification ChangeHandle = nullptr;
 	EOS_Presence_CreatePresenceModificationOptions Options = { };
 	Options.ApiVersion = EOS_PRESENCE_CREATEPRESENCEMODIFICATION_API_LATEST;
-	Options.LocalUserId = StringToAccountIdMap[EOSID.UniqueNetIdStr];
+	Options.LocalUserId = LocalAccountId;
 	EOS_Presence_CreatePresenceModification(EOSSubsystem->PresenceHandle, &Options, &ChangeHandle);
 	if (ChangeHandle == nullptr)
 	{
 		UE_LOG_ONLINE(Error, TEXT("Failed to create a modification handle for setting presence"));
+		TArray<FOnPresenceTaskCompleteDelegate> Delegates = MoveTemp(PublishState.QueuedDelegates);
+		PublishState.bHasPending = false;
+		EOSSubsystem->ExecuteNextTick([Delegates]()
+			{
+				for (const FOnPresenceTaskCompleteDelegate& Delegate : Delegates)
+				{
+					Delegate.ExecuteIfBound(*FUniqueNetIdEOS::EmptyId(), false);
+				}
+			});
 		return;
 	}
 
@@ -2188,27 +2443,104 @@ void FUserManagerEOS::SetPresence(const FUniqueNetId& UserId, const FOnlineUserP
 	}
 
 	FSetPresenceCallback* CallbackObj = new FSetPresenceCallback();
-	CallbackObj->CallbackLambda = [this, Delegate](const EOS_Presence_SetPresenceCallbackInfo* Data)
+	CallbackObj->CallbackLambda = [this](const EOS_Presence_SetPresenceCallbackInfo* Data)
 	{
-		if (Data->ResultCode == EOS_EResult::EOS_Success && AccountIdToStringMap.Contains(Data->LocalUserId))
+		const bool bWasSuccessful = Data->ResultCode == EOS_EResult::EOS_Success;
+		TArray<FOnPresenceTaskCompleteDelegate> Delegates;
+		FPresencePublishStateEOS* PublishState = PresencePublishStates.Find(Data->LocalUserId);
+		if (PublishState != nullptr)
+		{
+			Delegates = MoveTemp(PublishState->InFlightDelegates);
+			PublishState->bInFlight = false;
+			if (!bWasSuccessful)
+			{
+				// Don't skip the next write just because it matches one that didn't make it
+				PublishState->bHasPublished = false;
+			}
+		}
+
+		const FUserRecordEOS* Record = FindUserRecord(Data->LocalUserId);
+		if (bWasSuccessful && Record != nullptr)
 		{
-			FUniqueNetIdEOSRef EOSID = FUniqueNetIdEOS::Create(AccountIdToStringMap[Data->LocalUserId]);
-			Delegate.ExecuteIfBound(*EOSID, true);
+			FUniqueNetIdRef UserId = Record->OnlineUser->GetUserId();
+			for (const FOnPresenceTaskCompleteDelegate& Delegate : Delegates)
+			{
+				Delegate.ExecuteIfBound(*UserId, true);
+			}
 			return;
 		}
 		UE_LOG_ONLINE(Error, TEXT("SetPresence() failed with result code (%s)"), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
-		Delegate.ExecuteIfBound(*FUniqueNetIdEOS::EmptyId(), false);
+		for (const FOnPresenceTaskCompleteDelegate& Delegate : Delegates)
+		{
+			Delegate.ExecuteIfBound(*FUniqueNetIdEOS::EmptyId(), false);
+		}
 	};
 
+	// Everything merged so far is carried by this write
+	PublishState.InFlightDelegates = MoveTemp(PublishState.QueuedDelegates);
+	PublishState.PublishedStatus = Status;
+	PublishState.bHasPublished = true;
+	PublishState.bHasPending = false;
+	PublishState.bInFlight = true;
+	PublishState.LastSendTime = FPlatformTime::Seconds();
+
 	EOS_Presence_SetPresenceOptions PresOptions = { };
 	PresOptions.ApiVersion = EOS_PRESENCE_SETPRESENCE_API_LATEST;
-	PresOptions.LocalUserId = StringToAccountIdMap[EOSID.UniqueNetIdStr];
+	PresOptions.LocalUserId = LocalAccountId;
 	PresOptions.PresenceModificationHandle = ChangeHandle;
 	// Last step commit the changes
 	EOS_Presence_SetPresence(EOSSubsystem->PresenceHandle, &PresOptions, CallbackObj, CallbackObj->GetCallbackPtr());
 	EOS_PresenceModification_Release(ChangeHandle);
 }
 
+void FUserManagerEOS::DiscardPresencePublishes(EOS_EpicAccountId LocalAccountId)
+{
+	FPresencePublishStateEOS* PublishState = PresencePublishStates.Find(LocalAccountId);
+	if (PublishState == nullptr)
+	{
+		return;
+	}
+
+	// Writes that haven't gone out never will, so fail them now
+	TArray<FOnPresenceTaskCompleteDelegate> Delegates = MoveTemp(PublishState->QueuedDelegates);
+	EOSSubsystem->ExecuteNextTick([Delegates]()
+		{
+			for (const FOnPresenceTaskCompleteDelegate& Delegate : Delegates)
+			{
+				Delegate.ExecuteIfBound(*FUniqueNetIdEOS::EmptyId(), false);
+			}
+		});
+
+	// A write in flight still needs its state to complete its callers
+	if (PublishState->bInFlight)
+	{
+		PublishState->bHasPending = false;
+		PublishState->bHasPublished = false;
+	}
+	else
+	{
+		PresencePublishStates.Remove(LocalAccountId);
+	}
+}
+
+void FUserManagerEOS::TickPresencePublishes()
+{
+	if (PresencePublishStates.Num() == 0)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	for (TMap<EOS_EpicAccountId, FPresencePublishStateEOS>::TIterator It(PresencePublishStates); It; ++It)
+	{
+		FPresencePublishStateEOS& PublishState = It.Value();
+		if (PublishState.bHasPending && !PublishState.bInFlight && Now - PublishState.LastSendTime >= SetPresenceMinInterval)
+		{
+			DispatchPresence(It.Key(), PublishState);
+		}
+	}
+}
+
 typedef TEOSCallback<EOS_Presence_OnQueryPresenceCompleteCallback, EOS_Presence_QueryPresenceCallbackInfo> FQueryPresenceCallback;
 
 void FUserManagerEOS::QueryPresence(const FUniqueNetId& UserId, const FOnPresenceTaskCompleteDelegate& Delegate)
@@ -2222,7 +2554,8 @@ void FUserManagerEOS::QueryPresence(const FUniqueNetId& UserId, const FOnPresenc
 
 	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(UserId);
 	const FString& NetId = EOSID.UniqueNetIdStr;
-	if (!StringToAccountIdMap.Contains(NetId))
+	const FUserRecordEOS* UserRecord = FindUserRecord(EOSID);
+	if (UserRecord == nullptr)
 	{
 		UE_LOG_ONLINE(Error, TEXT("Can't QueryPresence(%s) for unknown unique net id"), *NetId);
 		Delegate.ExecuteIfBound(UserId, false);
@@ -2232,18 +2565,19 @@ void FUserManagerEOS::QueryPresence(const FUniqueNetId& UserId, const FOnPresenc
 	EOS_Presence_HasPresenceOptions HasOptions = { };
 	HasOptions.ApiVersion = EOS_PRESENCE_HASPRESENCE_API_LATEST;
 	HasOptions.LocalUserId = UserNumToAccountIdMap[DefaultLocalUser];
-	HasOptions.TargetUserId = StringToAccountIdMap[NetId];
+	HasOptions.TargetUserId = UserRecord->EpicAccountId;
 	EOS_Bool bHasPresence = EOS_Presence_HasPresence(EOSSubsystem->PresenceHandle, &HasOptions);
 	if (bHasPresence == EOS_FALSE)
 	{
 		FQueryPresenceCallback* CallbackObj = new FQueryPresenceCallback();
 		CallbackObj->CallbackLambda = [this, Delegate](const EOS_Presence_QueryPresenceCallbackInfo* Data)
 		{
-			if (Data->ResultCode == EOS_EResult::EOS_Success && EpicAccountIdToOnlineUserMap.Contains(Data->TargetUserId))
+			const FUserRecordEOS* Record = FindUserRecord(Data->TargetUserId);
+			if (Data->ResultCode == EOS_EResult::EOS_Success && Record != nullptr && Record->OnlineUser.IsValid())
 			{
+				FOnlineUserPtr OnlineUser = Record->OnlineUser;
 				// Update the presence data to the most recent
 				UpdatePresence(Data->TargetUserId);
-				FOnlineUserPtr OnlineUser = EpicAccountIdToOnlineUserMap[Data->TargetUserId];
 				Delegate.ExecuteIfBound(*OnlineUser->GetUserId(), true);
 				return;
 			}
@@ -2267,7 +2601,7 @@ void FUserManagerEOS::QueryPresence(const FUniqueNetId& UserId, const FOnPresenc
 	Delegate.ExecuteIfBound(UserId, true);
 }
 
-void FUserManagerEOS::UpdatePresence(EOS_EpicAccountId AccountId)
+bool FUserManagerEOS::UpdatePresence(EOS_EpicAccountId AccountId)
 {
 	EOS_Presence_Info* PresenceInfo = nullptr;
 	EOS_Presence_CopyPresenceOptions Options = { };
@@ -2277,30 +2611,29 @@ void FUserManagerEOS::UpdatePresence(EOS_EpicAccountId AccountId)
 	EOS_EResult CopyResult = EOS_Presence_CopyPresence(EOSSubsystem->PresenceHandle, &Options, &PresenceInfo);
 	if (CopyResult == EOS_EResult::EOS_Success)
 	{
-		const FString& NetId = AccountIdToStringMap[AccountId];
+		FUserRecordEOS* Record = FindUserRecord(AccountId);
+		check(Record != nullptr);
 		// Create it on demand if we don't have one yet
-		if (!NetIdStringToOnlineUserPresenceMap.Contains(NetId))
+		if (!Record->Presence.IsValid())
 		{
-			FOnlineUserPresenceRef PresenceRef = MakeShareable(new FOnlineUserPresence());
-			NetIdStringToOnlineUserPresenceMap.Emplace(NetId, PresenceRef);
+			Record->Presence = MakeShareable(new FOnlineUserPresence());
 		}
 
-		FOnlineUserPresenceRef PresenceRef = NetIdStringToOnlineUserPresenceMap[NetId];
-		FString ProductId(UTF8_TO_TCHAR(PresenceInfo->ProductId));
-		FString ProdVersion(UTF8_TO_TCHAR(PresenceInfo->ProductVersion));
-		FString Platform(UTF8_TO_TCHAR(PresenceInfo->Platform));
+		FOnlineUserPresenceRef PresenceRef = Record->Presence.ToSharedRef();
 		// Convert the presence data to our format
 		PresenceRef->Status.State = ToEOnlinePresenceState(PresenceInfo->Status);
 		PresenceRef->Status.StatusStr = PresenceInfo->RichText;
 		PresenceRef->bIsOnline = PresenceRef->Status.State == EOnlinePresenceState::Online;
-		PresenceRef->bIsPlaying = !ProductId.IsEmpty();
+		PresenceRef->bIsPlaying = PresenceInfo->ProductId != nullptr && PresenceInfo->ProductId[0] != '\0';
 		PresenceRef->bIsPlayingThisGame = FCStringAnsi::Strcmp(PresenceInfo->ProductId, EOSSubsystem->ProductNameAnsi) == 0 &&
 			FCStringAnsi::Strcmp(PresenceInfo->ProductVersion, EOSSubsystem->ProductVersionAnsi) == 0;
 //		PresenceRef->bIsJoinable = ???;
 //		PresenceRef->bHasVoiceSupport = ???;
-		PresenceRef->Status.Properties.Add(TEXT("ProductId"), ProductId);
-		PresenceRef->Status.Properties.Add(TEXT("ProductVersion"), ProdVersion);
-		PresenceRef->Status.Properties.Add(TEXT("Platform"), Platform);
+		// Replace the previous properties in place, so records the user dropped don't linger
+		PresenceRef->Status.Properties.Reset();
+		PresenceRef->Status.Properties.Add(TEXT("ProductId"), UTF8_TO_TCHAR(PresenceInfo->ProductId));
+		PresenceRef->Status.Properties.Add(TEXT("ProductVersion"), UTF8_TO_TCHAR(PresenceInfo->ProductVersion));
+		PresenceRef->Status.Properties.Add(TEXT("Platform"), UTF8_TO_TCHAR(PresenceInfo->Platform));
 		for (int32 Index = 0; Index < PresenceInfo->RecordsCount; Index++)
 		{
 			const EOS_Presence_DataRecord& Record = PresenceInfo->Records[Index];
@@ -2308,22 +2641,90 @@ void FUserManagerEOS::UpdatePresence(EOS_EpicAccountId AccountId)
 		}
 
 		// Copy the presence if this is a friend that was updated, so that their data is in sync
-		UpdateFriendPresence(NetId, PresenceRef);
+		UpdateFriendPresence(Record->NetIdKey, PresenceRef);
 
 		EOS_Presence_Info_Release(PresenceInfo);
+		return true;
 	}
-	else
+
+	UE_LOG_ONLINE(Error, TEXT("Failed to copy presence data with error code (%s)"), ANSI_TO_TCHAR(EOS_EResult_ToString(CopyResult)));
+	return false;
+}
+
+void FUserManagerEOS::QueuePresenceUpdate(EOS_EpicAccountId AccountId)
+{
+	bool bIsAlreadyQueued = false;
+	QueuedPresenceUpdateSet.Add(AccountId, &bIsAlreadyQueued);
+	if (bIsAlreadyQueued)
+	{
+		// The update already waiting will copy whatever is latest
+		return;
+	}
+	QueuedPresenceUpdates.Enqueue(AccountId);
+
+	if (!bIsPresenceUpdateScheduled)
 	{
-		UE_LOG_ONLINE(Error, TEXT("Failed to copy presence data with error code (%s)"), ANSI_TO_TCHAR(EOS_EResult_ToString(CopyResult)));
+		bIsPresenceUpdateScheduled = true;
+		EOSSubsystem->ExecuteNextTick([this]()
+			{
+				ProcessQueuedPresenceUpdates();
+			});
 	}
 }
 
-void FUserManagerEOS::UpdateFriendPresence(const FString& FriendId, FOnlineUserPresenceRef Presence)
+void FUserManagerEOS::ProcessQueuedPresenceUpdates()
+{
+	bIsPresenceUpdateScheduled = false;
+
+	// Presence is copied on behalf of the default user, so without one there's nothing to apply
+	if (DefaultLocalUser < 0)
+	{
+		QueuedPresenceUpdates.Empty();
+		QueuedPresenceUpdateSet.Reset();
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<TPair<FUniqueNetIdRef, FOnlineUserPresenceRef>> Updated;
+
+	// Always apply at least one update, even with a budget too small for it
+	int32 NumProcessed = 0;
+	EOS_EpicAccountId AccountId = nullptr;
+	while ((NumProcessed == 0 || PresenceUpdateBudget <= 0.0 || FPlatformTime::Seconds() - StartTime < PresenceUpdateBudget) && QueuedPresenceUpdates.Dequeue(AccountId))
+	{
+		QueuedPresenceUpdateSet.Remove(AccountId);
+		NumProcessed++;
+
+		// They may have been forgotten since the change was queued
+		const FUserRecordEOS* Record = FindUserRecord(AccountId);
+		if (Record != nullptr && Record->OnlineUser.IsValid() && UpdatePresence(AccountId))
+		{
+			Updated.Emplace(Record->OnlineUser->GetUserId(), Record->Presence.ToSharedRef());
+		}
+	}
+
+	// Tell listeners about the whole batch once it's been applied
+	for (const TPair<FUniqueNetIdRef, FOnlineUserPresenceRef>& Update : Updated)
+	{
+		TriggerOnPresenceReceivedDelegates(*Update.Key, Update.Value);
+	}
+
+	if (!QueuedPresenceUpdates.IsEmpty() && !bIsPresenceUpdateScheduled)
+	{
+		bIsPresenceUpdateScheduled = true;
+		EOSSubsystem->ExecuteNextTick([this]()
+			{
+				ProcessQueuedPresenceUpdates();
+			});
+	}
+}
+
+void FUserManagerEOS::UpdateFriendPresence(const FUniqueNetIdKeyEOS& FriendId, FOnlineUserPresenceRef Presence)
 {
 	for (TMap<int32, FFriendsListEOSRef>::TConstIterator It(LocalUserNumToFriendsListMap); It; ++It)
 	{
 		FFriendsListEOSRef FriendsList = It.Value();
-		FOnlineFriendEOSPtr Friend = FriendsList->GetByNetIdString(FriendId);
+		FOnlineFriendEOSPtr Friend = FriendsList->GetByNetIdKey(FriendId);
 		if (Friend.IsValid())
 		{
 			Friend->SetPresence(Presence);
@@ -2333,10 +2734,10 @@ void FUserManagerEOS::UpdateFriendPresence(const FString& FriendId, FOnlineUserP
 
 EOnlineCachedResult::Type FUserManagerEOS::GetCachedPresence(const FUniqueNetId& UserId, TSharedPtr<FOnlineUserPresence>& OutPresence)
 {
-	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(UserId);
-	if (NetIdStringToOnlineUserPresenceMap.Contains(EOSID.UniqueNetIdStr))
+	const FUserRecordEOS* Record = FindUserRecord(UserId);
+	if (Record != nullptr && Record->Presence.IsValid())
 	{
-		OutPresence = NetIdStringToOnlineUserPresenceMap[EOSID.UniqueNetIdStr];
+		OutPresence = Record->Presence;
 		return EOnlineCachedResult::Success;
 	}
 	return EOnlineCachedResult::NotFound;
@@ -2347,34 +2748,75 @@ EOnlineCachedResult::Type FUserManagerEOS::GetCachedPresenceForApp(const FUnique
 	return GetCachedPresence(UserId, OutPresence);
 }
 
+/** One QueryUserInfo() call, completed once every user in it has been read */
+struct FQueryUserInfoBatchEOS
+{
+	int32 LocalUserNum;
+	TArray<FUniqueNetIdRef> UserIds;
+	int32 NumOutstanding;
+	bool bWasSuccessful;
+
+	FQueryUserInfoBatchEOS(int32 InLocalUserNum, const TArray<FUniqueNetIdRef>& InUserIds)
+		: LocalUserNum(InLocalUserNum)
+		, UserIds(InUserIds)
+		, NumOutstanding(0)
+		, bWasSuccessful(true)
+	{
+	}
+};
+
 bool FUserManagerEOS::QueryUserInfo(int32 LocalUserNum, const TArray<FUniqueNetIdRef>& UserIds)
 {
-	// Trigger a query for each user in the list
+	TSharedRef<FQueryUserInfoBatchEOS> Batch = MakeShared<FQueryUserInfoBatchEOS>(LocalUserNum, UserIds);
+	const ReadUserInfoAsyncCallback OnUserRead = [this, Batch](bool bWasSuccessful)
+	{
+		Batch->bWasSuccessful &= bWasSuccessful;
+		if (--Batch->NumOutstanding == 0)
+		{
+			const FString ErrorStr = Batch->bWasSuccessful ? FString() : FString::Printf(TEXT("QueryUserInfo(%d) failed to read some of the users"), Batch->LocalUserNum);
+			TriggerOnQueryUserInfoCompleteDelegates(Batch->LocalUserNum, Batch->bWasSuccessful, Batch->UserIds, ErrorStr);
+		}
+	};
+
+	// Held until every read has been started, so reads that finish early can't complete the batch
+	Batch->NumOutstanding++;
 	for (const FUniqueNetIdRef& NetId : UserIds)
 	{
 		const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(*NetId);
+		const FUserRecordEOS* Record = FindUserRecord(EOSID);
 		// Skip querying for local users since we already have that data
-		if (StringToUserAccountMap.Contains(EOSID.UniqueNetIdStr))
+		if (Record != nullptr && Record->UserAccount.IsValid())
 		{
 			continue;
 		}
 		// Check to see if we know about this user or not
-		if (StringToAccountIdMap.Contains(EOSID.UniqueNetIdStr))
+		EOS_EpicAccountId AccountId = nullptr;
+		if (Record != nullptr)
 		{
-			EOS_EpicAccountId AccountId = StringToAccountIdMap[EOSID.UniqueNetIdStr];
-			ReadUserInfo(LocalUserNum, AccountId);
+			AccountId = Record->EpicAccountId;
 		}
 		else
 		{
 			// We need to build this one from the string
-			EOS_EpicAccountId AccountId = EOS_EpicAccountId_FromString(TCHAR_TO_UTF8(*EOSID.EpicAccountIdStr));
+			AccountId = EOS_EpicAccountId_FromString(TCHAR_TO_UTF8(*EOSID.EpicAccountIdStr));
 			if (EOS_EpicAccountId_IsValid(AccountId) == EOS_TRUE)
 			{
 				// Registering the player will also query the user info data
 				AddRemotePlayer(LocalUserNum, EOSID.UniqueNetIdStr, AccountId);
 			}
 		}
+		if (EOS_EpicAccountId_IsValid(AccountId) == EOS_TRUE)
+		{
+			// Joins the read AddRemotePlayer started, or the one already running for a known user
+			Batch->NumOutstanding++;
+			ReadUserInfoAsync(AccountId, OnUserRead);
+		}
 	}
+	// Released next tick, so a batch with nothing to read still completes after this returns, like one that had to query
+	EOSSubsystem->ExecuteNextTick([OnUserRead]()
+	{
+		OnUserRead(true);
+	});
 	return true;
 }
 
@@ -2382,62 +2824,127 @@ typedef TEOSCallback<EOS_UserInfo_OnQueryUserInfoCallback, EOS_UserInfo_QueryUse
 
 void FUserManagerEOS::ReadUserInfo(int32 LocalUserNum, EOS_EpicAccountId EpicAccountId)
 {
-	FReadUserInfoCallback* CallbackObj = new FReadUserInfoCallback();
-	CallbackObj->CallbackLambda = [this, LocalUserNum, EpicAccountId](const EOS_UserInfo_QueryUserInfoCallbackInfo* Data)
+	// We mark this player as pending for processing
+	NumUserInfoReadsOngoingForLocalUserMap.FindOrAdd(LocalUserNum)++;
+
+	ReadUserInfoAsync(EpicAccountId, [this, LocalUserNum](bool)
 	{
-		if (Data->ResultCode == EOS_EResult::EOS_Success)
+		// We mark this player as processed
+		int32* NumOngoing = NumUserInfoReadsOngoingForLocalUserMap.Find(LocalUserNum);
+		if (NumOngoing != nullptr && *NumOngoing > 0)
 		{
-			IAttributeAccessInterfaceRef AttributeAccessRef = EpicAccountIdToAttributeAccessMap[Data->TargetUserId];
-			UpdateUserInfo(AttributeAccessRef, Data->LocalUserId, Data->TargetUserId);
+			--(*NumOngoing);
 		}
 
-		// We mark this player as processed
-		IsFriendQueryUserInfoOngoingForLocalUserMap[LocalUserNum].Remove(EpicAccountId);
-
 		ProcessReadFriendsListComplete(LocalUserNum, true, TEXT(""));
-	};
+	});
+}
 
-	EOS_UserInfo_QueryUserInfoOptions Options = { };
-	Options.ApiVersion = EOS_USERINFO_QUERYUSERINFO_API_LATEST;
-	Options.LocalUserId = UserNumToAccountIdMap[DefaultLocalUser];
-	Options.TargetUserId = EpicAccountId;
-	EOS_UserInfo_QueryUserInfo(EOSSubsystem->UserInfoHandle, &Options, CallbackObj, CallbackObj->GetCallbackPtr());
+void FUserManagerEOS::ReadUserInfoAsync(EOS_EpicAccountId EpicAccountId, const ReadUserInfoAsyncCallback& Callback)
+{
+	// Info read recently enough is still in the SDK's cache, so just copy it over. This is done next tick
+	// so callers see the same ordering as they would for a query
+	if (UserInfoCacheTTL > 0.0)
+	{
+		const double* ReadTime = UserInfoReadTimes.FindAndTouch(EpicAccountId);
+		if (ReadTime != nullptr && FPlatformTime::Seconds() - *ReadTime < UserInfoCacheTTL)
+		{
+			EOSSubsystem->ExecuteNextTick([this, EpicAccountId, Callback]()
+			{
+				UpdateUserInfo(GetLocalEpicAccountId(), EpicAccountId);
+				Callback(true);
+			});
+			return;
+		}
+	}
 
-	// We mark this player as pending for processing
-	if (!IsFriendQueryUserInfoOngoingForLocalUserMap.Contains(LocalUserNum))
+	// Share the query if one is already queued or in flight for this user
+	TArray<ReadUserInfoAsyncCallback>* Waiters = UserInfoQueryWaiters.Find(EpicAccountId);
+	if (Waiters != nullptr)
+	{
+		Waiters->Add(Callback);
+		return;
+	}
+
+	UserInfoQueryWaiters.Add(EpicAccountId).Add(Callback);
+	QueuedUserInfoQueries.Enqueue(EpicAccountId);
+	StartQueuedUserInfoQueries();
+}
+
+void FUserManagerEOS::StartQueuedUserInfoQueries()
+{
+	EOS_EpicAccountId EpicAccountId = nullptr;
+	while ((MaxConcurrentUserInfoQueries <= 0 || NumUserInfoQueriesInFlight < MaxConcurrentUserInfoQueries) && QueuedUserInfoQueries.Dequeue(EpicAccountId))
 	{
-		IsFriendQueryUserInfoOngoingForLocalUserMap.Emplace(LocalUserNum);
+		NumUserInfoQueriesInFlight++;
+
+		FReadUserInfoCallback* CallbackObj = new FReadUserInfoCallback();
+		CallbackObj->CallbackLambda = [this, EpicAccountId](const EOS_UserInfo_QueryUserInfoCallbackInfo* Data)
+		{
+			NumUserInfoQueriesInFlight--;
+
+			const bool bWasSuccessful = Data->ResultCode == EOS_EResult::EOS_Success;
+			if (bWasSuccessful)
+			{
+				if (UserInfoCacheTTL > 0.0)
+				{
+					UserInfoReadTimes.Add(EpicAccountId, FPlatformTime::Seconds());
+				}
+				UpdateUserInfo(Data->LocalUserId, Data->TargetUserId);
+			}
+			else
+			{
+				UE_LOG_ONLINE(Warning, TEXT("EOS_UserInfo_QueryUserInfo() for user (%s) failed with result code (%s)"), *LexToString(EpicAccountId), ANSI_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+			}
+
+			TArray<ReadUserInfoAsyncCallback> Waiters;
+			UserInfoQueryWaiters.RemoveAndCopyValue(EpicAccountId, Waiters);
+			for (const ReadUserInfoAsyncCallback& Waiter : Waiters)
+			{
+				Waiter(bWasSuccessful);
+			}
+
+			StartQueuedUserInfoQueries();
+		};
+
+		EOS_UserInfo_QueryUserInfoOptions Options = { };
+		Options.ApiVersion = EOS_USERINFO_QUERYUSERINFO_API_LATEST;
+		Options.LocalUserId = GetLocalEpicAccountId();
+		Options.TargetUserId = EpicAccountId;
+		EOS_UserInfo_QueryUserInfo(EOSSubsystem->UserInfoHandle, &Options, CallbackObj, CallbackObj->GetCallbackPtr());
 	}
+}
 
-	IsFriendQueryUserInfoOngoingForLocalUserMap[LocalUserNum].Add(EpicAccountId);
+void FUserManagerEOS::UpdateUserInfo(EOS_EpicAccountId LocalId, EOS_EpicAccountId TargetId)
+{
+	const FUserRecordEOS* Record = FindUserRecord(TargetId);
+	if (Record != nullptr && Record->AttributeAccess.IsValid())
+	{
+		UpdateUserInfo(Record->AttributeAccess.ToSharedRef(), LocalId, TargetId);
+	}
 }
 
 bool FUserManagerEOS::GetAllUserInfo(int32 LocalUserNum, TArray<TSharedRef<FOnlineUser>>& OutUsers)
 {
 	OutUsers.Reset();
-	// Get remote users
-	for (TMap<FString, FOnlineUserPtr>::TConstIterator It(NetIdStringToOnlineUserMap); It; ++It)
+	// Local users' online user is their account, so one pass gets both remote and local users
+	for (const FUserRecordEOS& Record : UserRecords)
 	{
-		if (It.Value().IsValid())
+		if (Record.OnlineUser.IsValid())
 		{
-			OutUsers.Add(It.Value().ToSharedRef());
+			OutUsers.Add(Record.OnlineUser.ToSharedRef());
 		}
 	}
-	// Get local users
-	for (TMap<FString, FUserOnlineAccountEOSRef>::TConstIterator It(StringToUserAccountMap); It; ++It)
-	{
-		OutUsers.Add(It.Value());
-	}
 	return true;
 }
 
 TSharedPtr<FOnlineUser> FUserManagerEOS::GetUserInfo(int32 LocalUserNum, const FUniqueNetId& UserId)
 {
 	TSharedPtr<FOnlineUser> OnlineUser;
-	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(UserId);
-	if (NetIdStringToOnlineUserMap.Contains(EOSID.UniqueNetIdStr))
+	const FUserRecordEOS* Record = FindUserRecord(UserId);
+	if (Record != nullptr)
 	{
-		OnlineUser = NetIdStringToOnlineUserMap[EOSID.UniqueNetIdStr];
+		OnlineUser = Record->OnlineUser;
 	}
 	return OnlineUser;
 }
@@ -2459,8 +2966,8 @@ typedef TEOSCallback<EOS_UserInfo_OnQueryUserInfoByDisplayNameCallback, EOS_User
 bool FUserManagerEOS::QueryUserIdMapping(const FUniqueNetId& UserId, const FString& DisplayNameOrEmail, const FOnQueryUserMappingComplete& Delegate)
 {
 	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(UserId);
-	const FString& NetId = EOSID.UniqueNetIdStr;
-	if (!StringToAccountIdMap.Contains(NetId))
+	const FUserRecordEOS* UserRecord = FindUserRecord(EOSID);
+	if (UserRecord == nullptr)
 	{
 		UE_LOG_ONLINE(Error, TEXT("Specified local user (%s) is not known"), *EOSID.UniqueNetIdStr);
 		Delegate.ExecuteIfBound(false, UserId, DisplayNameOrEmail, *FUniqueNetIdEOS::EmptyId(), FString::Printf(TEXT("Specified local user (%s) is not known"), *EOSID.UniqueNetIdStr));
@@ -2484,7 +2991,7 @@ bool FUserManagerEOS::QueryUserIdMapping(const FUniqueNetId& UserId, const FStri
 		{
 			const FString NetIdStr = LexToString(Data->TargetUserId);
 			FUniqueNetIdEOSPtr LocalUserId = UserNumToNetIdMap[DefaultLocalUser];
-			if (!EpicAccountIdToOnlineUserMap.Contains(Data->TargetUserId))
+			if (FindUserRecord(Data->TargetUserId) == nullptr)
 			{
 				// Registering the player will also query the presence/user info data
 				AddRemotePlayer(LocalUserNum, NetIdStr, Data->TargetUserId);
@@ -2501,7 +3008,7 @@ bool FUserManagerEOS::QueryUserIdMapping(const FUniqueNetId& UserId, const FStri
 
 	FQueryByDisplayNameOptions Options;
 	FCStringAnsi::Strncpy(Options.DisplayNameAnsi, TCHAR_TO_UTF8(*DisplayNameOrEmail), EOS_PRODUCTNAME_MAX_BUFFER_LEN);
-	Options.LocalUserId = StringToAccountIdMap[NetId];
+	Options.LocalUserId = UserRecord->EpicAccountId;
 	EOS_UserInfo_QueryUserInfoByDisplayName(EOSSubsystem->UserInfoHandle, &Options, CallbackObj, CallbackObj->GetCallbackPtr());
 
 	return true;
@@ -2553,14 +3060,15 @@ typedef TEOSCallback<EOS_Connect_OnQueryExternalAccountMappingsCallback, EOS_Con
 bool FUserManagerEOS::QueryExternalIdMappings(const FUniqueNetId& UserId, const FExternalIdQueryOptions& QueryOptions, const TArray<FString>& ExternalIds, const FOnQueryExternalIdMappingsComplete& Delegate)
 {
 	const FUniqueNetIdEOS& EOSID = FUniqueNetIdEOS::Cast(UserId);
-	if (!StringToProductUserIdMap.Contains(EOSID.UniqueNetIdStr))
+	const FUserRecordEOS* UserRecord = FindUserRecord(EOSID);
+	if (UserRecord == nullptr || UserRecord->ProductUserId == nullptr)
 	{
 		Delegate.ExecuteIfBound(false, UserId, QueryOptions, ExternalIds, FString::Printf(TEXT("User (%s) is not logged in, so can't query external account ids"), *EOSID.UniqueNetIdStr));
 		return false;
 	}
 	int32 LocalUserNum = GetLocalUserNumFromUniqueNetId(UserId);
 
-	EOS_ProductUserId LocalUserId = StringToProductUserIdMap[EOSID.UniqueNetIdStr];
+	EOS_ProductUserId LocalUserId = UserRecord->ProductUserId;
 	const int32 NumBatches = (ExternalIds.Num() / EOS_CONNECT_QUERYEXTERNALACCOUNTMAPPINGS_MAX_ACCOUNT_IDS) + 1;
 	int32 QueryStart = 0;
 	// Process queries in batches since there's a max that can be done at once
@@ -2631,10 +3139,13 @@ FUniqueNetIdPtr FUserManagerEOS::GetExternalIdMapping(const FExternalIdQueryOpti
 {
 	FUniqueNetIdPtr NetId;
 	EOS_EpicAccountId AccountId = EOS_EpicAccountId_FromString(TCHAR_TO_UTF8(*ExternalId));
-	if (EOS_EpicAccountId_IsValid(AccountId) == EOS_TRUE && AccountIdToStringMap.Contains(AccountId))
+	if (EOS_EpicAccountId_IsValid(AccountId) == EOS_TRUE)
 	{
-		const FString& NetIdStr = AccountIdToStringMap[AccountId];
-		NetId = NetIdStringToOnlineUserMap[NetIdStr]->GetUserId();
+		const FUserRecordEOS* Record = FindUserRecord(AccountId);
+		if (Record != nullptr && Record->OnlineUser.IsValid())
+		{
+			NetId = Record->OnlineUser->GetUserId();
+		}
 	}
 	return NetId;
 }
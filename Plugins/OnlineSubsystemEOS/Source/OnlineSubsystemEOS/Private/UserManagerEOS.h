@@ -3,7 +3,10 @@
 #pragma once
 
 #include "OnlineSubsystemEOSTypes.h"
+#include "OnlineExtensionsEOS.h"
 #include "Interfaces/OnlineExternalUIInterface.h"
+#include "Containers/LruCache.h"
+#include "Containers/Queue.h"
 
 #if WITH_EOS_SDK
 	#include "eos_auth_types.h"
@@ -13,6 +16,9 @@
 class FOnlineSubsystemEOS;
 class IOnlineSubsystem;
 
+/** Product user ids sent per EOS_Connect_QueryProductUserIdMappings call. 128 is the documented per-call limit of that function */
+#define EOS_OSS_MAX_PRODUCT_USER_ID_MAPPINGS_PER_QUERY 128
+
 typedef TSharedPtr<FOnlineUser> FOnlineUserPtr;
 typedef TSharedRef<FOnlineUser> FOnlineUserRef;
 
@@ -101,6 +107,80 @@ public:
 typedef TSharedPtr<FOnlineRecentPlayerEOS> FOnlineRecentPlayerEOSPtr;
 typedef TSharedRef<FOnlineRecentPlayerEOS> FOnlineRecentPlayerEOSRef;
 
+/**
+ * The binary form of a FUniqueNetIdEOS (its RawBytes), used to key user lookups so they hash and
+ * compare 32 bytes instead of the ~65 character net id string
+ */
+struct FUniqueNetIdKeyEOS
+{
+	uint8 Bytes[EOS_ID_BYTE_SIZE];
+
+	FUniqueNetIdKeyEOS()
+	{
+		FMemory::Memzero(Bytes);
+	}
+
+	explicit FUniqueNetIdKeyEOS(const FUniqueNetIdEOS& NetId)
+	{
+		FMemory::Memcpy(Bytes, NetId.RawBytes, EOS_ID_BYTE_SIZE);
+	}
+
+	/** Builds the same key a net id made by MakeNetIdStringFromIds would have, without making one or any strings */
+	FUniqueNetIdKeyEOS(EOS_EpicAccountId AccountId, EOS_ProductUserId UserId)
+	{
+		FMemory::Memzero(Bytes);
+		char AccountIdStr[EOS_EPICACCOUNTID_MAX_LENGTH + 1];
+		int32_t AccountIdLen = sizeof(AccountIdStr);
+		if (EOS_EpicAccountId_IsValid(AccountId) == EOS_TRUE && EOS_EpicAccountId_ToString(AccountId, AccountIdStr, &AccountIdLen) == EOS_EResult::EOS_Success)
+		{
+			HexToHalf(AccountIdStr, Bytes);
+		}
+		char UserIdStr[EOS_PRODUCTUSERID_MAX_LENGTH + 1];
+		int32_t UserIdLen = sizeof(UserIdStr);
+		if (EOS_ProductUserId_IsValid(UserId) == EOS_TRUE && EOS_ProductUserId_ToString(UserId, UserIdStr, &UserIdLen) == EOS_EResult::EOS_Success)
+		{
+			HexToHalf(UserIdStr, Bytes + ID_HALF_BYTE_SIZE);
+		}
+	}
+
+	/** The same key with the product user id half cleared, as it was before that id resolved */
+	FUniqueNetIdKeyEOS GetEpicAccountIdKey() const
+	{
+		FUniqueNetIdKeyEOS Result;
+		FMemory::Memcpy(Result.Bytes, Bytes, ID_HALF_BYTE_SIZE);
+		return Result;
+	}
+
+	friend bool operator==(const FUniqueNetIdKeyEOS& A, const FUniqueNetIdKeyEOS& B)
+	{
+		return FMemory::Memcmp(A.Bytes, B.Bytes, EOS_ID_BYTE_SIZE) == 0;
+	}
+
+	friend bool operator!=(const FUniqueNetIdKeyEOS& A, const FUniqueNetIdKeyEOS& B)
+	{
+		return !(A == B);
+	}
+
+	friend uint32 GetTypeHash(const FUniqueNetIdKeyEOS& Key)
+	{
+		return FCrc::MemCrc32(Key.Bytes, EOS_ID_BYTE_SIZE);
+	}
+
+private:
+	/** Decodes an id string into one half of Bytes, leaving it zeroed unless the id is exactly a half's worth of hex, like HexToBytes */
+	static void HexToHalf(const char* Hex, uint8* OutHalf)
+	{
+		if (FCStringAnsi::Strlen(Hex) != ID_HALF_BYTE_SIZE * 2)
+		{
+			return;
+		}
+		for (int32 Index = 0; Index < ID_HALF_BYTE_SIZE; Index++)
+		{
+			OutHalf[Index] = (TCharToNibble(Hex[Index * 2]) << 4) | TCharToNibble(Hex[Index * 2 + 1]);
+		}
+	}
+};
+
 template<class ListClass, class ListClassReturnType>
 class TOnlinePlayerList
 {
@@ -110,8 +190,8 @@ class TOnlinePlayerList
 	FUniqueNetIdEOSRef OwningNetId;
 	/** The array of list class entries */
 	TArray<ListClass> ListEntries;
-	/** Indexed by string form of account id for fast look up */
-	TMap<FString, ListClass> NetIdStringToListEntryMap;
+	/** Indexed by the binary form of the net id for fast look up */
+	TMap<FUniqueNetIdKeyEOS, ListClass> NetIdKeyToListEntryMap;
 
 public:
 	TOnlinePlayerList(int32 InLocalUserNum, FUniqueNetIdEOSRef InOwningNetId)
@@ -125,33 +205,34 @@ public:
 		return ListEntries;
 	}
 
-	void Add(const FString& InNetId, ListClass InListEntry)
+	/** Entries by the key each was stored under, which follows the net id as its product user id resolves */
+	const TMap<FUniqueNetIdKeyEOS, ListClass>& GetNetIdKeyMap()
+	{
+		return NetIdKeyToListEntryMap;
+	}
+
+	void Add(const FUniqueNetIdKeyEOS& InNetId, ListClass InListEntry)
 	{
 		ListEntries.Add(InListEntry);
-		NetIdStringToListEntryMap.Add(InNetId, InListEntry);
+		NetIdKeyToListEntryMap.Add(InNetId, InListEntry);
 	}
 
-	void Remove(const FString& InNetId, ListClass InListEntry)
+	void Remove(const FUniqueNetIdKeyEOS& InNetId, ListClass InListEntry)
 	{
-		const ListClass* Found = NetIdStringToListEntryMap.Find(InNetId);
-		if (Found != nullptr)
-		{
-			NetIdStringToListEntryMap.Remove(InNetId);
-		}
+		NetIdKeyToListEntryMap.Remove(InNetId);
 		ListEntries.Remove(InListEntry);
 	}
 
 	void Empty()
 	{
 		ListEntries.Empty();
-		NetIdStringToListEntryMap.Empty();
+		NetIdKeyToListEntryMap.Empty();
 	}
 
-	void UpdateNetIdStr(const FString& PrevNetId, const FString& NewNetId)
+	void UpdateNetIdKey(const FUniqueNetIdKeyEOS& PrevNetId, const FUniqueNetIdKeyEOS& NewNetId)
 	{
-		ListClass ListEntry = NetIdStringToListEntryMap[PrevNetId];
-		NetIdStringToListEntryMap.Remove(PrevNetId);
-		NetIdStringToListEntryMap.Add(NewNetId, ListEntry);
+		ListClass ListEntry = NetIdKeyToListEntryMap.FindAndRemoveChecked(PrevNetId);
+		NetIdKeyToListEntryMap.Add(NewNetId, ListEntry);
 	}
 
 	ListClassReturnType GetByIndex(int32 Index)
@@ -163,9 +244,9 @@ public:
 		return ListClassReturnType();
 	}
 
-	ListClassReturnType GetByNetIdString(const FString& NetId)
+	ListClassReturnType GetByNetIdKey(const FUniqueNetIdKeyEOS& NetId)
 	{
-		const ListClass* Found = NetIdStringToListEntryMap.Find(NetId);
+		const ListClass* Found = NetIdKeyToListEntryMap.Find(NetId);
 		if (Found != nullptr)
 		{
 			return *Found;
@@ -213,6 +294,21 @@ public:
 
 typedef TSharedRef<FRecentPlayersListEOS> FRecentPlayersListEOSRef;
 
+/** Everything the user manager knows about one user, local or remote */
+struct FUserRecordEOS
+{
+	/** What the record is indexed by, which changes once a remote user's product user id is known */
+	FUniqueNetIdKeyEOS NetIdKey;
+	EOS_EpicAccountId EpicAccountId = nullptr;
+	EOS_ProductUserId ProductUserId = nullptr;
+	/** Only set for locally registered users */
+	FUserOnlineAccountEOSPtr UserAccount;
+	FOnlineUserPtr OnlineUser;
+	IAttributeAccessInterfacePtr AttributeAccess;
+	/** Created the first time presence is read for the user */
+	FOnlineUserPresencePtr Presence;
+};
+
 struct FNotificationIdCallbackPair
 {
 	EOS_NotificationId NotificationId;
@@ -230,6 +326,24 @@ struct FNotificationIdCallbackPair
 	}
 };
 
+/** Write-behind state for one local user's presence, see FUserManagerEOS::SetPresence */
+struct FPresencePublishStateEOS
+{
+	/** What the next write will send, merged from every SetPresence since the last one */
+	FOnlineUserPresenceStatus PendingStatus;
+	bool bHasPending = false;
+	/** What the last write sent. Cleared when it fails, since we no longer know what the backend has */
+	FOnlineUserPresenceStatus PublishedStatus;
+	bool bHasPublished = false;
+	/** SetPresence calls the next write completes */
+	TArray<FOnPresenceTaskCompleteDelegate> QueuedDelegates;
+	/** SetPresence calls the write in flight completes */
+	TArray<FOnPresenceTaskCompleteDelegate> InFlightDelegates;
+	bool bInFlight = false;
+	/** FPlatformTime::Seconds() when the last write was sent to the backend */
+	double LastSendTime = 0.0;
+};
+
 /**
  * EOS service implementation of the online identity, friends, and user info interfaces
  *
@@ -241,6 +355,7 @@ class FUserManagerEOS
 	, public IOnlineFriends
 	, public IOnlinePresence
 	, public IOnlineUser
+	, public IOnlineFriendsEventsEOS
 {
 public:
 	/**
@@ -355,7 +470,7 @@ PACKAGE_SCOPE:
 
 	typedef TFunction<void(const EOS_ProductUserId& ProductUserId, EOS_EpicAccountId& EpicAccountId)> GetEpicAccountIdAsyncCallback;
 	bool GetEpicAccountIdFromProductUserId(const EOS_ProductUserId& ProductUserId, EOS_EpicAccountId& OutEpicAccountId) const;
-	void GetEpicAccountIdAsync(const EOS_ProductUserId& ProductUserId, const GetEpicAccountIdAsyncCallback& Callback) const;
+	void GetEpicAccountIdAsync(const EOS_ProductUserId& ProductUserId, const GetEpicAccountIdAsyncCallback& Callback);
 
 	FOnlineUserPtr GetLocalOnlineUser(int32 LocalUserNum) const;
 	FOnlineUserPtr GetOnlineUser(EOS_ProductUserId UserId) const;
@@ -379,26 +494,62 @@ PACKAGE_SCOPE:
 
 	int32 GetDefaultLocalUser() const { return DefaultLocalUser; }
 
+	void Tick(float DeltaTime);
+
 private:
 	void RemoveLocalUser(int32 LocalUserNum);
 	void AddLocalUser(int32 LocalUserNum, EOS_EpicAccountId EpicAccountId, EOS_ProductUserId UserId);
 
-	void AddFriend(int32 LocalUserNum, EOS_EpicAccountId EpicAccountId);
+	FOnlineFriendEOSRef AddFriend(int32 LocalUserNum, EOS_EpicAccountId EpicAccountId);
 	void AddRemotePlayer(int32 LocalUserNum, const FString& NetId, EOS_EpicAccountId EpicAccountId);
 	void AddRemotePlayer(int32 LocalUserNum, const FString& NetId, EOS_EpicAccountId EpicAccountId, FUniqueNetIdEOSPtr UniqueNetId, FOnlineUserPtr OnlineUser, IAttributeAccessInterfaceRef AttributeRef);
 	void UpdateRemotePlayerProductUserId(EOS_EpicAccountId AccountId, EOS_ProductUserId UserId);
 	void ReadUserInfo(int32 LocalUserNum, EOS_EpicAccountId EpicAccountId);
 
+	typedef TFunction<void(bool bWasSuccessful)> ReadUserInfoAsyncCallback;
+	/** Reads a user's info, sharing a query already queued or in flight for them and skipping it if their info is still cached */
+	void ReadUserInfoAsync(EOS_EpicAccountId EpicAccountId, const ReadUserInfoAsyncCallback& Callback);
+	/** Starts queued user info queries until MaxConcurrentUserInfoQueries are in flight */
+	void StartQueuedUserInfoQueries();
+
 	void UpdateUserInfo(IAttributeAccessInterfaceRef AttriubteAccessRef, EOS_EpicAccountId LocalId, EOS_EpicAccountId TargetId);
+	/** Copies the SDK's info for a user onto their record, if we have one */
+	void UpdateUserInfo(EOS_EpicAccountId LocalId, EOS_EpicAccountId TargetId);
 	bool IsFriendQueryUserInfoOngoing(int32 LocalUserNum);
 	void ProcessReadFriendsListComplete(int32 LocalUserNum, bool bWasSuccessful, const FString& ErrorStr);
-
-	void UpdatePresence(EOS_EpicAccountId AccountId);
-	void UpdateFriendPresence(const FString& FriendId, FOnlineUserPresenceRef Presence);
+	/** Brings a local user's friends list in line with the SDK's, touching only the friends that changed */
+	void RefreshFriendsList(int32 LocalUserNum);
+
+	bool UpdatePresence(EOS_EpicAccountId AccountId);
+	/** Queues a presence change to be applied next tick, once per user no matter how many changes arrive */
+	void QueuePresenceUpdate(EOS_EpicAccountId AccountId);
+	/** Applies queued presence changes until the per tick budget runs out, then tells listeners about them */
+	void ProcessQueuedPresenceUpdates();
+	/** Sends a local user's pending presence, or completes it right away when it matches what was last sent */
+	void DispatchPresence(EOS_EpicAccountId LocalAccountId, FPresencePublishStateEOS& PublishState);
+	/** Fails a local user's presence writes that haven't gone out yet, for when they log out */
+	void DiscardPresencePublishes(EOS_EpicAccountId LocalAccountId);
+	/** Sends pending presence writes whose interval has passed */
+	void TickPresencePublishes();
+	void UpdateFriendPresence(const FUniqueNetIdKeyEOS& FriendId, FOnlineUserPresenceRef Presence);
+
+	/** Identity table look ups, returning null for users we don't know about */
+	FUserRecordEOS* FindUserRecord(const FUniqueNetId& NetId);
+	const FUserRecordEOS* FindUserRecord(const FUniqueNetId& NetId) const;
+	FUserRecordEOS* FindUserRecord(EOS_EpicAccountId AccountId);
+	const FUserRecordEOS* FindUserRecord(EOS_EpicAccountId AccountId) const;
+	const FUserRecordEOS* FindUserRecord(EOS_ProductUserId UserId) const;
+	/** Gets the record for a net id, creating one if needed, and indexes it by whichever of the ids are valid */
+	FUserRecordEOS& FindOrAddUserRecord(const FUniqueNetIdKeyEOS& NetIdKey, EOS_EpicAccountId AccountId, EOS_ProductUserId UserId);
+	/** Moves a record to a new key, e.g. once the product user id half of it is known */
+	void RekeyUserRecord(FUserRecordEOS& Record, const FUniqueNetIdKeyEOS& NewNetIdKey);
+	void RemoveUserRecord(const FUniqueNetIdKeyEOS& NetIdKey);
 
 	IOnlineSubsystem* GetPlatformOSS();
 	void GetPlatformAuthToken(int32 LocalUserNum, const FOnGetLinkedAccountAuthTokenCompleteDelegate& Delegate);
 
+	void QueryPendingEpicAccountIds();
+
 	/** Cached pointer to owning subsystem */
 	FOnlineSubsystemEOS* EOSSubsystem;
 
@@ -420,35 +571,34 @@ private:
 	TMap<int32, FUniqueNetIdEOSPtr> UserNumToNetIdMap;
 	TMap<int32, EOS_ProductUserId> UserNumToProductUserIdMap;
 	TMap<EOS_ProductUserId, int32> ProductUserIdToUserNumMap;
-	TMap<FString, FUserOnlineAccountEOSRef> StringToUserAccountMap;
 
-	/** General account mappings */
-	TMap<EOS_EpicAccountId, FString> AccountIdToStringMap;
-	TMap<EOS_ProductUserId, FString> ProductUserIdToStringMap;
-	TMap<FString, EOS_EpicAccountId> StringToAccountIdMap;
-	TMap<FString, EOS_ProductUserId> StringToProductUserIdMap;
+	/** One record per known user, local or remote, addressed by a stable index */
+	TSparseArray<FUserRecordEOS> UserRecords;
+	/** Indices into UserRecords by each of the ids a user can be looked up with */
+	TMap<FUniqueNetIdKeyEOS, int32> NetIdKeyToUserRecordMap;
+	TMap<EOS_EpicAccountId, int32> AccountIdToUserRecordMap;
+	TMap<EOS_ProductUserId, int32> ProductUserIdToUserRecordMap;
 
-	/** Per user friends lists accessible by user num or net id */
+	/** Per user friends lists accessible by user num */
 	TMap<int32, FFriendsListEOSRef> LocalUserNumToFriendsListMap;
-	TMap<FString, FFriendsListEOSRef> NetIdStringToFriendsListMap;
-	/** Per user blocked player lists accessible by user num or net id */
+	/** Per user blocked player lists accessible by user num */
 	TMap<int32, FBlockedPlayersListEOSRef> LocalUserNumToBlockedPlayerListMap;
-	TMap<FString, FBlockedPlayersListEOSRef> NetIdStringToBlockedPlayerListMap;
-	/** Per user recent player lists accessible by user num or net id */
+	/** Per user recent player lists accessible by user num */
 	TMap<int32, FRecentPlayersListEOSRef> LocalUserNumToRecentPlayerListMap;
-	TMap<FString, FRecentPlayersListEOSRef> NetIdStringToRecentPlayerListMap;
 
-	/** Ids mapped to remote users */
-	TMap<FString, FOnlineUserPtr> NetIdStringToOnlineUserMap;
-	TMap<EOS_EpicAccountId, FOnlineUserPtr> EpicAccountIdToOnlineUserMap;
-	TMap<FString, IAttributeAccessInterfaceRef> NetIdStringToAttributeAccessMap;
-	TMap<EOS_EpicAccountId, IAttributeAccessInterfaceRef> EpicAccountIdToAttributeAccessMap;
+	/** Number of user info reads each local user is still waiting on, so a friends list read knows when it is done */
+	TMap<int32, int32> NumUserInfoReadsOngoingForLocalUserMap;
 
-	/** Ids mapped to remote user presence */
-	TMap<FString, FOnlineUserPresenceRef> NetIdStringToOnlineUserPresenceMap;
-
-	/** Id map to keep track of which friends have been processed during async user info queries */
-	TMap<int32, TArray<EOS_EpicAccountId>> IsFriendQueryUserInfoOngoingForLocalUserMap;
+	/** Users with a user info query queued or in flight, with everyone waiting on each */
+	TMap<EOS_EpicAccountId, TArray<ReadUserInfoAsyncCallback>> UserInfoQueryWaiters;
+	/** Users whose user info query hasn't been started yet, in the order they were asked for */
+	TQueue<EOS_EpicAccountId> QueuedUserInfoQueries;
+	int32 NumUserInfoQueriesInFlight;
+	/** 0 means no limit */
+	int32 MaxConcurrentUserInfoQueries;
+	/** When each recently read user's info was read. Only used when UserInfoCacheTTL is set */
+	TLruCache<EOS_EpicAccountId, double> UserInfoReadTimes;
+	double UserInfoCacheTTL;
 
 	/** Cache for the info passed on to ReadFriendsList, kept while user info queries complete */
 	struct ReadUserListInfo
@@ -469,10 +619,37 @@ private:
 
 	TMap<int32, TArray<ReadUserListInfo>> CachedReadUserListInfoForLocalUserMap;
 
+	/** What the running ReadFriendsList changed, reported once it completes */
+	struct FFriendsListDeltaEOS
+	{
+		TArray<FUniqueNetIdRef> Added;
+		TArray<FUniqueNetIdRef> Removed;
+	};
+	TMap<int32, FFriendsListDeltaEOS> PendingFriendsListDeltaMap;
+
 	/** Identifier for the external UI notification callback */
 	EOS_NotificationId DisplaySettingsUpdatedId;
 	FCallbackBase* DisplaySettingsUpdatedCallback;
 
+	/** Product user ids GetEpicAccountIdAsync was asked for this frame, with everyone waiting on each */
+	TMap<EOS_ProductUserId, TArray<GetEpicAccountIdAsyncCallback>> PendingEpicAccountIdQueries;
+	/** Product user ids whose mapping query hasn't come back yet, with everyone waiting on each */
+	TMap<EOS_ProductUserId, TArray<GetEpicAccountIdAsyncCallback>> InFlightEpicAccountIdQueries;
+	/** Whether QueryPendingEpicAccountIds is already due to run next tick */
+	bool bIsEpicAccountIdQueryScheduled;
+
+	/** Users whose presence changed and hasn't been applied yet, in the order they changed */
+	TQueue<EOS_EpicAccountId> QueuedPresenceUpdates;
+	/** The same users, so repeated changes for one user collapse into a single update */
+	TSet<EOS_EpicAccountId> QueuedPresenceUpdateSet;
+	/** Whether ProcessQueuedPresenceUpdates is already due to run next tick */
+	bool bIsPresenceUpdateScheduled;
+	double PresenceUpdateBudget;
+
+	/** Presence writes for each local user, kept so unchanged presence isn't sent again */
+	TMap<EOS_EpicAccountId, FPresencePublishStateEOS> PresencePublishStates;
+	double SetPresenceMinInterval;
+
 	/** Last Login Credentials used for a login attempt */
 	TMap<int32, TSharedRef<FOnlineAccountCredentials>> LocalUserNumToLastLoginCredentials;
 };
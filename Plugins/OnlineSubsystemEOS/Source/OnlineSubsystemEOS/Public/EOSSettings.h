@@ -71,6 +71,16 @@ struct FEOSSettings
 	FString DefaultArtifactName;
 	int32 TickBudgetInMilliseconds;
 	int32 TitleStorageReadChunkLength;
+	int32 SessionUpdateMinIntervalInMilliseconds;
+	int32 SessionSearchResultsBudgetInMilliseconds;
+	int32 SessionSearchCacheTTLInMilliseconds;
+	bool bRevalidateStaleSessionSearches;
+	int32 MaxConcurrentUserInfoQueries;
+	int32 UserInfoCacheTTLInMilliseconds;
+	int32 UserInfoCacheMaxEntries;
+	int32 PresenceUpdateBudgetInMilliseconds;
+	int32 SetPresenceMinIntervalInMilliseconds;
+	bool bUseP2PNetworkThread;
 	bool bEnableOverlay;
 	bool bEnableSocialOverlay;
 	bool bShouldEnforceBeingLaunchedByEGS;
@@ -127,6 +137,49 @@ public:
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
 	int32 TitleStorageReadChunkLength = 0;
 
+	/** Minimum time between two updates of the same session. Updates made in between are merged into the next one. 0 only merges while an update is in flight */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	int32 SessionUpdateMinIntervalInMilliseconds = 0;
+
+	/** Time per tick spent turning session search results into FOnlineSessionSearchResults, each tick's batch is delivered as a page. 0 converts them all as soon as the search completes */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	int32 SessionSearchResultsBudgetInMilliseconds = 0;
+
+	/** How long the results of a session search are reused by later searches with the same query. 0 disables the cache */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	int32 SessionSearchCacheTTLInMilliseconds = 0;
+
+	/** Whether a search whose cached results have expired still gets them straight away, while they are refreshed in the background */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	bool bRevalidateStaleSessionSearches = false;
+
+	/** Most user info queries that can be waiting on the backend at once, the rest queue until one finishes. 0 means no limit */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	int32 MaxConcurrentUserInfoQueries = 0;
+
+	/** How long user info that was read stays fresh enough to be used again without another query. 0 disables the cache */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	int32 UserInfoCacheTTLInMilliseconds = 0;
+
+	/** Most users whose info is cached, the least recently used are dropped past this */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	int32 UserInfoCacheMaxEntries = 0;
+
+	/** Time per tick spent applying queued presence changes, the rest wait for the next tick. 0 applies them all each tick */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	int32 PresenceUpdateBudgetInMilliseconds = 0;
+
+	/** Minimum time between two presence writes for the same local user. Writes made in between are merged into the next one. 0 only merges while a write is in flight */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	int32 SetPresenceMinIntervalInMilliseconds = 0;
+
+	/**
+	 * Make every P2P SDK call for EOS sockets (sends, receives, accepts, closes and notifications) on a dedicated thread,
+	 * with the sockets exchanging packets with it through queues. Read when the online subsystem starts
+	 */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
+	bool bUseP2PNetworkThread = false;
+
 	/** Per artifact SDK settings. A game might have a FooStaging, FooQA, and public Foo artifact */
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="EOS Settings")
 	TArray<FArtifactSettings> Artifacts;
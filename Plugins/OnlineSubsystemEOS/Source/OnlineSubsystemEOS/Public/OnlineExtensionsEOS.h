@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineDelegateMacros.h"
+#include "OnlineSessionSettings.h"
+
+/**
+ * Delegate fired each time a search delivers another batch of results
+ *
+ * @param SearchSettings the search being filled in
+ * @param FirstNewResult index into SearchSettings->SearchResults of the first result in this batch
+ */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnFindSessionsPageReceived, const TSharedRef<FOnlineSessionSearch>& /*SearchSettings*/, int32 /*FirstNewResult*/);
+typedef FOnFindSessionsPageReceived::FDelegate FOnFindSessionsPageReceivedDelegate;
+
+/**
+ * Session search events the generic session interface has no room for. See FOnlineSubsystemEOS::GetSessionSearchEventsEOS
+ */
+class ONLINESUBSYSTEMEOS_API IOnlineSessionSearchEventsEOS
+{
+public:
+	virtual ~IOnlineSessionSearchEventsEOS() = default;
+
+	/** Fires as search results are converted, before OnFindSessionsComplete. Results can be shown from here on */
+	DEFINE_ONLINE_DELEGATE_TWO_PARAM(OnFindSessionsPageReceived, const TSharedRef<FOnlineSessionSearch>&, int32);
+};
+
+typedef TSharedPtr<IOnlineSessionSearchEventsEOS, ESPMode::ThreadSafe> IOnlineSessionSearchEventsEOSPtr;
+
+/**
+ * Delegate fired once a ReadFriendsList completes with the friends it added to and removed from the local user's list
+ *
+ * @param LocalUserNum the user whose list was read
+ * @param Added friends that weren't in the list before the read
+ * @param Removed friends that were in the list before the read but no longer are
+ */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnFriendsListDelta, int32 /*LocalUserNum*/, const TArray<FUniqueNetIdRef>& /*Added*/, const TArray<FUniqueNetIdRef>& /*Removed*/);
+typedef FOnFriendsListDelta::FDelegate FOnFriendsListDeltaDelegate;
+
+/**
+ * Friends events the generic friends interface has no room for. See FOnlineSubsystemEOS::GetFriendsEventsEOS
+ */
+class ONLINESUBSYSTEMEOS_API IOnlineFriendsEventsEOS
+{
+public:
+	virtual ~IOnlineFriendsEventsEOS() = default;
+
+	/** Carries what changed in a friends list, since OnFriendsChange doesn't. Fires after OnReadFriendsListComplete */
+	DEFINE_ONLINE_DELEGATE_THREE_PARAM(OnFriendsListDelta, int32, const TArray<FUniqueNetIdRef>&, const TArray<FUniqueNetIdRef>&);
+};
+
+typedef TSharedPtr<IOnlineFriendsEventsEOS, ESPMode::ThreadSafe> IOnlineFriendsEventsEOSPtr;
@@ -6,6 +6,7 @@
 #include "OnlineSubsystemNames.h"
 #include "OnlineSubsystemImpl.h"
 #include "SocketSubsystemEOS.h"
+#include "OnlineExtensionsEOS.h"
 
 #include COMPILED_PLATFORM_HEADER(EOSHelpers.h)
 
@@ -113,6 +114,11 @@ public:
 
 	IVoiceChatUser* GetVoiceChatUserInterface(const FUniqueNetId& LocalUserId);
 
+	/** @return the EOS specific session search events, such as results arriving a page at a time */
+	IOnlineSessionSearchEventsEOSPtr GetSessionSearchEventsEOS() const;
+	/** @return the EOS specific friends events, such as what a friends list read changed */
+	IOnlineFriendsEventsEOSPtr GetFriendsEventsEOS() const;
+
 PACKAGE_SCOPE:
 	/** Only the factory makes instances */
 	FOnlineSubsystemEOS() = delete;
@@ -218,6 +224,9 @@ public:
 	virtual bool Init() override { return false; }
 	virtual bool Shutdown() override { return true; }
 	virtual FString GetAppId() const override { return TEXT(""); }
+
+	IOnlineSessionSearchEventsEOSPtr GetSessionSearchEventsEOS() const { return nullptr; }
+	IOnlineFriendsEventsEOSPtr GetFriendsEventsEOS() const { return nullptr; }
 };
 
 #endif